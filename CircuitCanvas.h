@@ -9,6 +9,26 @@
 #include "Gate.h"
 #include "InputOutput.h"
 #include "Sequence.h"
+#include "ElementFactory.h"
+#include "NetGraph.h"
+#include "SimulationEngine.h"
+#include "NetlistBuilder.h"
+#include "core/AnalysisCache.h"
+#include "core/BinaryCircuitFile.h"
+#include "core/CircuitBdd.h"
+#include "core/CircuitFile.h"
+#include "core/CircuitSnapshot.h"
+#include "core/CompiledCircuit.h"
+#include "core/CoordinateIndex.h"
+#include "core/EquivalenceChecker.h"
+#include "core/IncrementalEvaluator.h"
+#include "core/ModelExporter.h"
+#include "core/ParallelEvaluator.h"
+#include "core/SaveThread.h"
+#include "core/SequentialCircuit.h"
+#include "core/SimulationThread.h"
+#include "core/StructuralHash.h"
+#include "core/TruthTable.h"
 
 // 前向声明
 class TruthTableDialog;
@@ -24,7 +44,10 @@ public:
         autoPlaceMode(false), autoPlaceType(TYPE_SELECT),
         virtualSize(2000, 2000), isRestoringState(false),
         pasteOffset(0, 0), pasteCount(0), selectedWire(nullptr),
-        connectionScrollPos(0), maxConnectionWidth(0) {  // 新增滚动相关变量
+        connectionScrollPos(0), maxConnectionWidth(0),  // 新增滚动相关变量
+        simulationMode(SIM_EVENT_DRIVEN), compiledDirty(true), compiledValuesValid(false), parallelEvaluation(false), sequentialDirty(true),
+        simulationTimer(this, ID_SIMULATION_TIMER), backgroundRestart(false), structuralHash(0), structuralHashDirty(true),
+        saveTimer(this, ID_SAVE_TIMER), autosaveTimer(this, ID_AUTOSAVE_TIMER), autosaveMarker(0) {
 
         // 设置滚动条
         SetScrollRate(10, 10);  // 设置滚动步长
@@ -43,6 +66,9 @@ public:
         Bind(wxEVT_KEY_DOWN, &CircuitCanvas::OnKeyDown, this);
         Bind(wxEVT_SIZE, &CircuitCanvas::OnSize, this);
         Bind(wxEVT_MENU, &CircuitCanvas::OnContextMenu, this);
+        Bind(wxEVT_TIMER, &CircuitCanvas::OnSimulationTimer, this, simulationTimer.GetId());
+        Bind(wxEVT_TIMER, &CircuitCanvas::OnSaveTimer, this, saveTimer.GetId());
+        Bind(wxEVT_TIMER, &CircuitCanvas::OnAutosaveTimer, this, autosaveTimer.GetId());
 
         // 绑定滚动事件
         Bind(wxEVT_SCROLLWIN_THUMBTRACK, &CircuitCanvas::OnScroll, this);
@@ -162,8 +188,8 @@ public:
             wxYES_NO | wxICON_QUESTION);
 
         if (dialog.ShowModal() == wxID_YES) {
-            // 序列化导线数据用于撤销
-            wxString serializedData = SerializeWire(selectedWire);
+            // 按两端引脚的引用记录，用于撤销
+            WireRef ref = MakeWireRef(selectedWire);
 
             // 找到要删除的导线
             auto it = std::find_if(wires.begin(), wires.end(),
@@ -172,12 +198,11 @@ public:
                 });
 
             if (it != wires.end()) {
-                // 保存要删除的导线
-                std::unique_ptr<Wire> wireToDelete = std::move(*it);
+                netGraph.RemoveWire(it->get());
+                Pin* readerPin = (*it)->GetEndPin();
 
                 // 记录删除操作到撤销栈
-                auto operation = std::make_unique<DeleteWireOperation>(
-                    std::move(wireToDelete), serializedData);
+                auto operation = std::make_unique<DeleteWireOperation>(ref);
 
                 // 限制历史记录数量
                 if (undoStack.size() >= MAX_HISTORY) {
@@ -189,6 +214,7 @@ public:
 
                 // 从导线列表中移除
                 wires.erase(it);
+                OnLocalTopologyChange({ readerPin });
 
                 // 清除选中状态
                 selectedWire = nullptr;
@@ -217,30 +243,26 @@ public:
         bool hasPrevious = false;
         for (auto pin : pins) {
             if (pin->IsInput()) {
-                Wire* connectedWire = pin->GetConnectedWire();
-                if (connectedWire) {
-                    Pin* startPin = connectedWire->GetStartPin();
-                    if (startPin && startPin->GetParent() != selectedElement) {
-                        if (hasPrevious) info << ", ";
-                        info << startPin->GetParent()->GetDisplayName();
-                        hasPrevious = true;
-                    }
+                Pin* driver = netGraph.GetDriverOf(pin);
+                if (driver && driver->GetParent() && driver->GetParent() != selectedElement) {
+                    if (hasPrevious) info << ", ";
+                    info << driver->GetParent()->GetDisplayName();
+                    hasPrevious = true;
                 }
             }
         }
         if (!hasPrevious) info << "None";
 
-        // 分析输出连接（下一个门）
+        // 分析输出连接（下一个门），一个输出引脚可驱动多个读取者
         info << " | Outputs to: ";
         bool hasNext = false;
         for (auto pin : pins) {
-            if (!pin->IsInput()) {
-                Wire* connectedWire = pin->GetConnectedWire();
-                if (connectedWire) {
-                    Pin* endPin = connectedWire->GetEndPin();
-                    if (endPin && endPin->GetParent() != selectedElement) {
+            if (!pin->IsInput() && netGraph.GetFanout(pin) > 0) {
+                for (Wire* wire : netGraph.GetWires(pin->GetNet())) {
+                    CircuitElement* reader = wire->GetEndPin()->GetParent();
+                    if (reader && reader != selectedElement) {
                         if (hasNext) info << ", ";
-                        info << endPin->GetParent()->GetDisplayName();
+                        info << reader->GetDisplayName();
                         hasNext = true;
                     }
                 }
@@ -281,13 +303,14 @@ public:
             return;
         }
 
-        // 为撤销操作收集数据
-        std::vector<std::pair<std::unique_ptr<CircuitElement>, wxString>> deletedElements;
+        // 为撤销操作收集数据：元件的序列化结果和稳定 ID，以及随元件删除的导线
+        std::vector<ElementRecord> deletedElements;
+        std::vector<WireRef> deletedWires;
 
         // 删除收集到的元件
         for (auto element : elementsToDelete) {
             // 序列化元件数据用于撤销
-            wxString serializedData = SerializeElement(element);
+            ElementRecord record{ element->GetId(), SerializeElement(element) };
 
             // 找到要删除的元件
             auto it = std::find_if(elements.begin(), elements.end(),
@@ -302,27 +325,28 @@ public:
                     // 找到并删除连接到该引脚的所有导线
                     for (auto wireIt = wires.begin(); wireIt != wires.end(); ) {
                         if ((*wireIt)->GetStartPin() == pin || (*wireIt)->GetEndPin() == pin) {
+                            if (!(*wireIt)->HasVirtualPin()) deletedWires.push_back(MakeWireRef(wireIt->get()));
+                            netGraph.RemoveWire(wireIt->get());
                             wireIt = wires.erase(wireIt);
                         }
                         else {
                             ++wireIt;
                         }
                     }
-                    // 清除引脚的连接
-                    pin->SetConnectedWire(nullptr);
                 }
 
-                // 保存要删除的元件和序列化数据
-                deletedElements.push_back(std::make_pair(std::move(*it), serializedData));
+                // 保存序列化数据
+                deletedElements.push_back(record);
 
                 // 从元素列表中移除
-                elements.erase(it);
+                EraseElement(it);
+                OnTopologyChanged();
             }
         }
 
         // 记录批量删除操作到撤销栈
         if (!deletedElements.empty() && !isRestoringState) {
-            auto operation = std::make_unique<BatchDeleteOperation>(std::move(deletedElements));
+            auto operation = std::make_unique<BatchDeleteOperation>(std::move(deletedElements), std::move(deletedWires));
 
             // 限制历史记录数量
             if (undoStack.size() >= MAX_HISTORY) {
@@ -347,43 +371,18 @@ public:
 
     // 在指定位置创建元件，支持时序元件
     void CreateElementAtPosition(ElementType type, const wxPoint& pos) {
-        std::unique_ptr<CircuitElement> newElement;
-
-        // 根据元件类型创建相应的元件对象
-        if (type >= TYPE_AND && type <= TYPE_NOR) {  // 逻辑门元件
-            newElement = std::make_unique<Gate>(type, pos.x, pos.y);
-        }
-        else if (type == TYPE_INPUT || type == TYPE_OUTPUT) {  // 输入输出元件
-            newElement = std::make_unique<InputOutput>(type, pos.x, pos.y);
-        }
-        else if (type == TYPE_CLOCK) {  // 时钟元件
-            newElement = std::make_unique<ClockElement>(pos.x, pos.y);
-        }
-        else if (type == TYPE_RS_FLIPFLOP) {  // RS触发器 - 新增
-            newElement = std::make_unique<RSFlipFlop>(pos.x, pos.y);
-        }
-        else if (type == TYPE_D_FLIPFLOP) {  // D触发器
-            newElement = std::make_unique<DFlipFlop>(pos.x, pos.y);
-        }
-        else if (type == TYPE_JK_FLIPFLOP) {  // JK触发器
-            newElement = std::make_unique<JKFlipFlop>(pos.x, pos.y);
-        }
-        else if (type == TYPE_T_FLIPFLOP) {  // T触发器
-            newElement = std::make_unique<TFlipFlop>(pos.x, pos.y);
-        }
-        else if (type == TYPE_REGISTER) {  // 寄存器
-            newElement = std::make_unique<RegisterElement>(pos.x, pos.y);
-        }
+        // 按元件类型查工厂表创建相应的元件对象
+        std::unique_ptr<CircuitElement> newElement = ElementFactory::Create(type, pos.x, pos.y);
 
         // 如果成功创建元件，将其添加到元件列表
         if (newElement) {
-            CircuitElement* elementPtr = newElement.get();
-            elements.push_back(std::move(newElement));
+            CircuitElement* elementPtr = InsertElement(std::move(newElement));
+            OnLocalTopologyChange(elementPtr->GetPins());
 
             // 记录添加元件操作（用于撤销/重做）
             if (!isRestoringState) {
                 wxString serializedData = SerializeElement(elementPtr);
-                auto operation = std::make_unique<AddElementOperation>(serializedData);
+                auto operation = std::make_unique<AddElementOperation>(serializedData, elementPtr->GetId());
                 undoStack.push_back(std::move(operation));
 
                 // 限制历史记录数量
@@ -476,6 +475,9 @@ public:
             }
         }
         UpdateCircuit();  // 更新电路状态
+
+        // 含时序元件时由后台线程按实时时钟推进
+        StartBackgroundSimulation(SimulationThread::MODE_REALTIME);
         Refresh();  // 刷新显示
     }
 
@@ -489,9 +491,49 @@ public:
         return wires;
     }
 
+    // 获取线网连接图
+    const NetGraph& GetNetGraph() const {
+        return netGraph;
+    }
+
+    // 电路的结构哈希（元件类型和连接，与坐标无关），逻辑被修改后才重新计算
+    uint64_t GetStructuralHash() {
+        if (structuralHashDirty) {
+            Netlist netlist;
+            NetlistBuilder::Build(elements, wires, netlist);
+            structuralHash = StructuralHash::Compute(netlist);
+            structuralHashDirty = false;
+        }
+        return structuralHash;
+    }
+
+    // 按结构哈希缓存的真值表
+    AnalysisCache<TruthTableData>& GetTruthTableCache() {
+        return truthTableCache;
+    }
+
+    // 每个输出的 BDD（按结构哈希缓存）；电路不是无环组合电路或 BDD 过大时返回空指针
+    std::shared_ptr<const CircuitBdd> GetOutputBdds(wxString* error = nullptr) {
+        uint64_t key = GetStructuralHash();
+        std::shared_ptr<const CircuitBdd> cached = bddCache.Find(key);
+        if (cached) return cached;
+
+        Netlist netlist;
+        NetlistBuilder::Build(elements, wires, netlist);
+        auto bdd = std::make_shared<CircuitBdd>();
+        std::string message;
+        if (!bdd->Build(netlist, &message)) {
+            if (error) *error = wxString::FromUTF8(message.c_str());
+            return nullptr;
+        }
+        bddCache.Store(key, bdd);
+        return bdd;
+    }
+
     // 停止仿真
     void StopSimulation() {
         simulating = false;
+        StopBackgroundSimulation();
 
         // 将所有输入元件的值设为0（false）
         for (auto& element : elements) {
@@ -508,48 +550,161 @@ public:
         Refresh();  // 刷新显示
     }
 
-    // 更新整个电路状态
-    void UpdateCircuit() {
-        // 多次迭代确保信号稳定传播
-        for (int i = 0; i < 5; ++i) {
-            // 先更新输入元件
-            for (auto& element : elements) {
-                if (element->GetType() == TYPE_INPUT) {
-                    element->Update();
-                }
-            }
+    // 更新整个电路状态（事件驱动：只重新求值引脚值发生变化的扇出）
+    SimulationResult UpdateCircuit() {
+        if (simulationMode == SIM_COMPILED && RunCompiled()) {
+            simulator.DiscardDirty();
+            return lastSimulationResult;
+        }
+        lastSimulationResult = simulator.Run(elements, netGraph);
+        return lastSimulationResult;
+    }
 
-            // 更新导线传递信号
-            for (auto& wire : wires) {
-                wire->Update();
-            }
+    // 单步仿真：含时序元件时按周期推进 steps 个时钟步，否则重新求值组合逻辑
+    SimulationResult Step(size_t steps = 1) {
+        StopBackgroundSimulation();  // 单步以后台线程的最后状态为起点
+        if (HasSequentialElements() && RunSequential(steps)) {
+            return lastSimulationResult;
+        }
+        return UpdateCircuit();
+    }
 
-            // 更新逻辑门元件
-            for (auto& element : elements) {
-                if (element->GetType() >= TYPE_AND && element->GetType() <= TYPE_NOR) {
-                    element->Update();
-                }
-            }
+    // 是否含有时钟、触发器或寄存器
+    bool HasSequentialElements() const {
+        for (auto& element : elements) {
+            if (CompiledCircuit::IsSequential(element->GetType())) return true;
+        }
+        return false;
+    }
 
-            // 再次更新导线
-            for (auto& wire : wires) {
-                wire->Update();
-            }
+    // 元件属性被修改后调用（时钟频率等参数在编译时读取）
+    void OnElementPropertiesChanged() {
+        sequentialDirty = true;
+        backgroundRestart = backgroundSimulation.IsRunning();
+        structuralHashDirty = true;
+    }
 
-            // 更新输出元件
-            for (auto& element : elements) {
-                if (element->GetType() == TYPE_OUTPUT) {
-                    element->Update();
-                }
+    // 在后台线程上运行时序电路（实时或尽快模式）；电路不含时序元件或无法编译时返回 false
+    bool StartBackgroundSimulation(SimulationThread::Mode mode) {
+        StopBackgroundSimulation();
+        if (!HasSequentialElements() || !PrepareSequential()) return false;
+        backgroundSimulation.Start(sequentialCircuit, mode);
+        backgroundRestart = false;
+        simulationTimer.Start(SimulationThread::SNAPSHOT_INTERVAL_MS);
+        return true;
+    }
+
+    // 停止后台线程，并把最后的快照写回画布
+    void StopBackgroundSimulation() {
+        if (!backgroundSimulation.IsRunning()) return;
+        simulationTimer.Stop();
+        backgroundSimulation.Stop();
+        TakeFinalBackgroundSnapshot();
+        Refresh();
+    }
+
+    bool IsBackgroundSimulationRunning() const { return backgroundSimulation.IsRunning(); }
+
+    // 切换后台线程的运行模式（暂停、实时、尽快）
+    void SetBackgroundSimulationMode(SimulationThread::Mode mode) {
+        if (backgroundSimulation.IsRunning()) backgroundSimulation.SetMode(mode);
+    }
+
+    // 获取最近一次仿真的统计结果
+    const SimulationResult& GetLastSimulationResult() const { return lastSimulationResult; }
+
+    // 设置仿真模式
+    void SetSimulationMode(SimulationMode mode) {
+        simulationMode = mode;
+        OnTopologyChanged();  // 切换后重新建立全部引脚值
+        UpdateCircuit();
+        Refresh();
+    }
+
+    SimulationMode GetSimulationMode() const { return simulationMode; }
+
+    // 事件驱动仿真的迭代轮数上限（0 为自动）
+    void SetIterationLimit(size_t limit) { simulator.SetIterationLimit(limit); }
+    size_t GetIterationLimit() const { return simulator.GetIterationLimit(); }
+
+    // 编译模式下按层并行求值（大电路的宽层分给线程池）
+    void SetParallelEvaluation(bool enable) {
+        parallelEvaluation = enable;
+        UpdateCircuit();
+        Refresh();
+    }
+
+    bool IsParallelEvaluation() const { return parallelEvaluation; }
+    unsigned GetParallelWorkerCount() const { return parallelEvaluator.GetWorkerCount(); }
+
+    // 编译模式是否可用于当前电路（不可用时返回原因）
+    bool IsCompiledModeActive(wxString* reason = nullptr) {
+        EnsureCompiled();
+        if (reason) *reason = wxString(compiledCircuit.GetError());
+        return compiledCircuit.IsValid();
+    }
+
+    // 只仿真这些输出元件的扇入锥（空表示全部元件）；扇入锥以外的引脚保持原值。
+    // 扇入锥随编译结果和扇出表缓存，电路被编辑后重新提取
+    void SetWatchedOutputs(const std::vector<CircuitElement*>& outputs) {
+        watchedOutputs.clear();
+        for (CircuitElement* element : outputs) {
+            if (element->GetType() == TYPE_OUTPUT) watchedOutputs.push_back(element);
+        }
+        simulator.SetCone(watchedOutputs);
+        compiledDirty = true;
+        UpdateCircuit();
+        Refresh();
+    }
+
+    const std::vector<CircuitElement*>& GetWatchedOutputs() const { return watchedOutputs; }
+
+    // 被观察的输出在全部输出中的下标（画布顺序，与真值表的输出列一致）；没有设置时为空
+    std::vector<int> GetWatchedOutputIndices() const {
+        std::vector<int> indices;
+        int index = 0;
+        for (auto& element : elements) {
+            if (element->GetType() != TYPE_OUTPUT) continue;
+            if (std::find(watchedOutputs.begin(), watchedOutputs.end(), element.get()) != watchedOutputs.end()) {
+                indices.push_back(index);
             }
+            index++;
+        }
+        return indices;
+    }
+
+    // 选中的输出元件
+    std::vector<CircuitElement*> GetSelectedOutputs() const {
+        std::vector<CircuitElement*> outputs;
+        for (auto& element : elements) {
+            if (element->IsSelected() && element->GetType() == TYPE_OUTPUT) outputs.push_back(element.get());
+        }
+        return outputs;
+    }
+
+    // 最近一次仿真中扇入锥的规模：编译模式下为指令数，事件驱动模式下为元件数
+    void GetConeStatistics(size_t& coneSize, size_t& totalSize) {
+        if (simulationMode == SIM_COMPILED && compiledCircuit.IsValid()) {
+            totalSize = compiledCircuit.GetProgram().size();
+            coneSize = compiledCone.IsValid() ? compiledCone.GetProgram().size() : totalSize;
+        }
+        else {
+            totalSize = simulator.GetNodeCount();
+            coneSize = simulator.GetConeSize();
         }
     }
 
     // 清空画布
     void Clear() {
+        watchedOutputs.clear();  // 观察的输出随元件一起清除
+        simulator.SetCone(watchedOutputs);
         elements.clear();  // 清空元件
+        elementById.clear();  // 撤销栈随后清空，稳定 ID 可以从头分配
+        autosaveMarker = 0;   // 新的或刚加载的电路没有需要自动保存的修改
+        netGraph.Clear(); // 清空线网图
         wires.clear();     // 清空导线
         virtualPins.clear(); // 新增：清空虚拟引脚
+        OnTopologyChanged();
         selectedElement = nullptr;  // 清除选中
         startPin = nullptr;         // 清除连线起始引脚
         autoPlaceMode = false;      // 关闭自动放置模式
@@ -560,126 +715,138 @@ public:
         Refresh();  // 刷新显示
     }
 
-    // 保存电路图
-    bool SaveCircuit(const wxString& filename) {
-        wxFile file;
-        if (file.Create(filename, true)) {
-            wxString data;
+    // 电路的文本形式（与电路文件的内容相同）
+    wxString SerializeCircuit() const {
+        wxString data;
 
-            // 保存所有元件
-            for (auto& element : elements) {
-                element->Serialize(data);
-                data += "\n";
-            }
+        // 保存所有元件；稳定 ID -> 元件行序号
+        std::vector<uint32_t> lineOfId(elementById.size(), 0);
+        uint32_t line = 0;
+        for (auto& element : elements) {
+            element->Serialize(data);
+            data += "\n";
+            lineOfId[element->GetId()] = line++;
+        }
 
-            // 保存所有导线 
-            for (auto& wire : wires) {
-                Pin* startPin = wire->GetStartPin();
-                Pin* endPin = wire->GetEndPin();
+        // 保存所有导线：两端的元件行序号和引脚下标。连接到导线连接点（虚拟引脚）的导线不保存
+        for (auto& wire : wires) {
+            if (wire->HasVirtualPin()) continue;
+            WireRef ref = MakeWireRef(wire.get());
+            if (ref.start.element == 0 || ref.end.element == 0) continue;
+            data += wxString::Format("LINK,%u,%u,%u,%u\n", lineOfId[ref.start.element], ref.start.pin,
+                lineOfId[ref.end.element], ref.end.pin);
+        }
+        return data;
+    }
 
-                if (startPin && endPin) {
-                    // 保存起始引脚和结束引脚的坐标
-                    data += wxString::Format("WIRE,%d,%d,%d,%d\n",
-                        startPin->GetX(), startPin->GetY(),
-                        endPin->GetX(), endPin->GetY());
-                }
-            }
+    // 后台保存结果的轮询间隔；自动保存的默认周期
+    enum : int { SAVE_POLL_MS = 100, AUTOSAVE_INTERVAL_SECONDS = 60 };
 
-            file.Write(data);
-            file.Close();
-            return true;
-        }
-        return false;
+    // 在后台线程保存：界面线程只复制元件和导线的纯数据快照，格式化和写文件不阻塞编辑。
+    // 完成后在状态栏报告结果，失败时弹出提示
+    void SaveCircuitInBackground(const wxString& filename) {
+        SubmitSave(filename, false);
     }
 
-    // 加载电路图
-    bool LoadCircuit(const wxString& filename) {
-        wxFile file;
-        if (file.Open(filename)) {
-            wxString data;
-            file.ReadAll(&data);
-            file.Close();
+    // 每隔 intervalSeconds 秒把有修改的电路保存到 filename（同样在后台线程），filename 为空时关闭自动保存
+    void SetAutosave(const wxString& filename, int intervalSeconds = AUTOSAVE_INTERVAL_SECONDS) {
+        autosaveFilename = filename;
+        autosaveTimer.Stop();
+        if (!filename.empty() && intervalSeconds > 0) autosaveTimer.Start(intervalSeconds * 1000);
+    }
 
-            Clear();  // 清空当前画布
+    // 等待已提交的保存全部写完并报告结果。关闭窗口、打开或新建电路之前调用，
+    // 否则正在写的文件可能被读到旧内容，退出时保存失败也无人报告。有手动保存失败时返回 false
+    bool FinishSaving() {
+        if (saveThread.IsBusy()) {
+            wxBusyCursor busy;
+            saveThread.Stop();  // 写完队列中的任务再返回；之后的提交会重新启动线程
+        }
+        saveTimer.Stop();
+        return ReportSaveResults();
+    }
 
-            // 第一遍：加载所有元件
-            wxStringTokenizer lines(data, "\n");
-            while (lines.HasMoreTokens()) {
-                wxString line = lines.GetNextToken().Trim();
-                if (line.empty()) continue;
+    // 用文本形式的电路替换画布内容（例如逻辑最小化的结果），可以撤销
+    void ReplaceCircuit(const wxString& data) {
+        std::vector<uint32_t> ids;
+        for (auto& element : elements) ids.push_back(element->GetId());
+        auto operation = std::make_unique<ReplaceCircuitOperation>(SerializeCircuit(), std::move(ids), data);
+        isRestoringState = true;
+        operation->Execute(this);
+        isRestoringState = false;
 
-                wxStringTokenizer tokens(line, ",");
-                if (tokens.HasMoreTokens()) {
-                    wxString firstToken = tokens.GetNextToken();
+        if (undoStack.size() >= MAX_HISTORY) {
+            undoStack.erase(undoStack.begin());
+        }
+        undoStack.push_back(std::move(operation));
+        redoStack.clear();
+        UpdateUndoRedoStatus();
+        Refresh();
+        NotifyStateChange();
+        UpdateStatusBar();
+    }
 
-                    if (firstToken == "WIRE") {
-                        // 导线在第二遍处理
-                        continue;
-                    }
-                    else {
-                        long typeVal;
-                        if (firstToken.ToLong(&typeVal)) {
-                            ElementType type = static_cast<ElementType>(typeVal);
-
-                            // 根据类型创建相应的元件
-                            if (type >= TYPE_AND && type <= TYPE_NOR) {
-                                auto gate = std::make_unique<Gate>(type, 0, 0);
-                                gate->Deserialize(line);
-                                elements.push_back(std::move(gate));
-                            }
-                            else if (type == TYPE_INPUT || type == TYPE_OUTPUT) {
-                                auto io = std::make_unique<InputOutput>(type, 0, 0);
-                                io->Deserialize(line);
-                                elements.push_back(std::move(io));
-                            }
-                        }
-                    }
-                }
-            }
+    // 把电路导出为独立的 C++ 仿真模型（className.h / .cpp 和驱动程序 className_main.cpp）
+    bool ExportModel(const wxString& directory, const wxString& className, wxString* error = nullptr) {
+        Netlist netlist;
+        NetlistBuilder::Build(elements, wires, netlist);
+        std::string message;
+        if (ModelExporter::Write(netlist, std::string(directory.utf8_str()), className.ToStdString(), &message)) return true;
+        if (error) *error = wxString::FromUTF8(message.c_str());
+        return false;
+    }
 
-            // 第二遍：重建导线连接
-            lines = wxStringTokenizer(data, "\n");
-            while (lines.HasMoreTokens()) {
-                wxString line = lines.GetNextToken().Trim();
-                if (line.empty()) continue;
-
-                wxStringTokenizer tokens(line, ",");
-                if (tokens.HasMoreTokens()) {
-                    wxString firstToken = tokens.GetNextToken();
-
-                    if (firstToken == "WIRE") {
-                        if (tokens.CountTokens() >= 4) {
-                            long startX, startY, endX, endY;
-                            tokens.GetNextToken().ToLong(&startX);
-                            tokens.GetNextToken().ToLong(&startY);
-                            tokens.GetNextToken().ToLong(&endX);
-                            tokens.GetNextToken().ToLong(&endY);
-
-                            // 通过坐标查找对应的引脚
-                            Pin* startPin = FindPinByPosition(startX, startY);
-                            Pin* endPin = FindPinByPosition(endX, endY);
-
-                            if (startPin && endPin && startPin->IsInput() != endPin->IsInput()) {
-                                // 确保连接方向正确：输出引脚 -> 输入引脚
-                                if (!startPin->IsInput() && endPin->IsInput()) {
-                                    wires.push_back(std::make_unique<Wire>(startPin, endPin));
-                                }
-                                else if (startPin->IsInput() && !endPin->IsInput()) {
-                                    wires.push_back(std::make_unique<Wire>(endPin, startPin));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+    // 检查当前电路与电路文件是否组合等价（输入输出按顺序对应），结果保存在 checker 中
+    bool CheckEquivalence(const wxString& filename, EquivalenceChecker& checker, wxString* error = nullptr) {
+        Netlist current, other;
+        NetlistBuilder::Build(elements, wires, current);
+        std::string message;
+        if (CircuitFile::Load(std::string(filename.utf8_str()), other, &message) && checker.Check(current, other, &message)) {
+            return true;
+        }
+        if (error) *error = wxString::FromUTF8(message.c_str());
+        return false;
+    }
 
+    // 加载电路图（文本或二进制格式，按文件开头的标识区分），读取的字节数和耗时记录在 lastLoadStats 中
+    bool LoadCircuit(const wxString& filename) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::string path(filename.utf8_str());  // 核心库的路径为 UTF-8
+        if (BinaryCircuitFile::IsBinaryFile(path)) {
+            BinaryCircuitReader reader;
+            if (!reader.Open(path)) return false;
+            Clear();
+            ParseBinaryCircuit(reader);
+            lastLoadStats = CircuitTextReader::Stats();
+            lastLoadStats.bytes = reader.GetFileSize();
+            lastLoadStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            OnTopologyChanged();
             UpdateCircuit();
             Refresh();
             return true;
         }
-        return false;
+
+        // 文本格式按块流式读取：一遍创建元件并记下连接行，读完后按元件行序号连接导线
+        CircuitTextReader reader;
+        if (!reader.Open(path)) return false;
+        Clear();  // 清空当前画布
+        ParsedCircuitText parsed;
+        reader.Read([this, &parsed](const CircuitTextReader::ElementLine& line) { AddParsedElement(parsed, line, nullptr); },
+            [&parsed](const CircuitTextReader::WireLine& line) { parsed.wireLines.push_back(line); },
+            [&parsed](const CircuitTextReader::LinkLine& line) { parsed.links.push_back(line); });
+        ConnectParsedWires(parsed);
+        lastLoadStats = reader.GetStats();
+        lastLoadStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        OnTopologyChanged();
+        UpdateCircuit();
+        Refresh();
+        return true;
     }
 
+    // 最近一次 LoadCircuit 读取的字节数、行数（文本格式）和耗时
+    const CircuitTextReader::Stats& GetLastLoadStats() const { return lastLoadStats; }
+
     // 切换网格显示
     void ToggleGrid() {
         showGrid = !showGrid;
@@ -824,8 +991,11 @@ public:
     // 复制粘贴相关公共方法
     void CopySelectedElements() {
         clipboard.clear();
+        clipboardWires.clear();
         pasteCount = 0;
 
+        // 稳定 ID -> 剪贴板中的下标（未复制的元件为 -1）
+        std::vector<int> clipboardIndex(elementById.size(), -1);
         for (auto& element : elements) {
             if (element->IsSelected()) {
                 // 序列化然后反序列化来创建深拷贝
@@ -833,13 +1003,27 @@ public:
                 element->Serialize(data);
 
                 // 根据类型创建新元件
-                std::unique_ptr<CircuitElement> newElement = CreateElementFromData(data);
+                std::unique_ptr<CircuitElement> newElement = ElementFactory::CreateFromData(data);
                 if (newElement) {
+                    clipboardIndex[element->GetId()] = static_cast<int>(clipboard.size());
                     clipboard.push_back(std::move(newElement));
                 }
             }
         }
 
+        // 两端都被复制的导线，端点记为剪贴板下标和引脚下标
+        for (auto& wire : wires) {
+            if (wire->HasVirtualPin()) continue;
+            WireRef ref = MakeWireRef(wire.get());
+            if (ref.start.element == 0 || ref.end.element == 0) continue;
+            int start = clipboardIndex[ref.start.element];
+            int end = clipboardIndex[ref.end.element];
+            if (start < 0 || end < 0) continue;
+            ref.start.element = static_cast<uint32_t>(start);
+            ref.end.element = static_cast<uint32_t>(end);
+            clipboardWires.push_back(ref);
+        }
+
         if (!clipboard.empty()) {
             // 更新状态栏
             UpdateStatusBar();
@@ -858,7 +1042,10 @@ public:
         }
 
         // 添加剪贴板中的元件到画布
-        for (auto& element : clipboard) {
+        std::vector<CircuitElement*> pasted(clipboard.size(), nullptr);
+        ReserveElements(clipboard.size());
+        for (size_t i = 0; i < clipboard.size(); ++i) {
+            auto& element = clipboard[i];
             // 创建新位置
             int newX = element->GetX() + pasteOffset.x;
             int newY = element->GetY() + pasteOffset.y;
@@ -866,19 +1053,20 @@ public:
             // 序列化然后创建新元件
             wxString data;
             element->Serialize(data);
-            std::unique_ptr<CircuitElement> newElement = CreateElementFromData(data);
+            std::unique_ptr<CircuitElement> newElement = ElementFactory::CreateFromData(data);
 
             if (newElement) {
                 newElement->SetPosition(newX, newY);
                 newElement->SetSelected(true);  // 选中粘贴的元件
 
-                CircuitElement* elementPtr = newElement.get();
-                elements.push_back(std::move(newElement));
+                CircuitElement* elementPtr = InsertElement(std::move(newElement));
+                pasted[i] = elementPtr;
+                OnLocalTopologyChange(elementPtr->GetPins());
 
                 // 记录添加操作（用于撤销）
                 if (!isRestoringState) {
                     wxString serializedData = SerializeElement(elementPtr);
-                    auto operation = std::make_unique<AddElementOperation>(serializedData);
+                    auto operation = std::make_unique<AddElementOperation>(serializedData, elementPtr->GetId());
                     undoStack.push_back(std::move(operation));
 
                     if (undoStack.size() > MAX_HISTORY) {
@@ -890,6 +1078,25 @@ public:
             }
         }
 
+        // 重建被复制元件之间的导线：按剪贴板下标直接取得粘贴出的元件
+        for (const WireRef& ref : clipboardWires) {
+            if (!pasted[ref.start.element] || !pasted[ref.end.element]) continue;
+            Pin* start = PinAt(pasted[ref.start.element], ref.start.pin);
+            Pin* end = PinAt(pasted[ref.end.element], ref.end.pin);
+            if (!start || !end || start->IsInput() || !end->IsInput()) continue;
+            Wire* wirePtr = AddWire(start, end);
+            OnLocalTopologyChange({ end });
+
+            if (!isRestoringState) {
+                undoStack.push_back(std::make_unique<AddWireOperation>(MakeWireRef(wirePtr)));
+                if (undoStack.size() > MAX_HISTORY) {
+                    undoStack.erase(undoStack.begin());
+                }
+                redoStack.clear();
+                UpdateUndoRedoStatus();
+            }
+        }
+
         UpdateCircuit();
         Refresh();
 
@@ -937,39 +1144,38 @@ public:
 
         if (dialog.ShowModal() == wxID_YES) {
             // 序列化元件数据用于撤销
-            wxString serializedData = SerializeElement(selectedElement);
+            ElementRecord record{ selectedElement->GetId(), SerializeElement(selectedElement) };
+            std::vector<WireRef> deletedWires;
 
             // 找到要删除的元件
-            std::unique_ptr<CircuitElement> elementToDelete;
             auto it = std::find_if(elements.begin(), elements.end(),
                 [this](const std::unique_ptr<CircuitElement>& elem) {
                     return elem.get() == selectedElement;
                 });
 
             if (it != elements.end()) {
-                // 先断开所有引脚连接
+                // 先断开所有引脚连接；另一端的输入引脚需要重新取值
                 auto pins = selectedElement->GetPins();
+                std::vector<Pin*> affectedPins;
                 for (auto pin : pins) {
                     // 找到并删除连接到该引脚的所有导线
                     for (auto wireIt = wires.begin(); wireIt != wires.end(); ) {
                         if ((*wireIt)->GetStartPin() == pin || (*wireIt)->GetEndPin() == pin) {
-                            // 记录导线删除操作（如果需要撤销）
+                            // 另一端的读取引脚需要重新取值；自环导线的另一端是本元件的输入引脚，随元件一起释放
+                            Pin* endPin = (*wireIt)->GetEndPin();
+                            if (endPin->GetParent() != selectedElement) affectedPins.push_back(endPin);
+                            if (!(*wireIt)->HasVirtualPin()) deletedWires.push_back(MakeWireRef(wireIt->get()));
+                            netGraph.RemoveWire(wireIt->get());
                             wireIt = wires.erase(wireIt);
                         }
                         else {
                             ++wireIt;
                         }
                     }
-                    // 清除引脚的连接
-                    pin->SetConnectedWire(nullptr);
                 }
 
-                // 保存要删除的元件
-                elementToDelete = std::move(*it);
-
                 // 记录删除操作到撤销栈
-                auto operation = std::make_unique<DeleteElementOperation>(
-                    std::move(elementToDelete), serializedData);
+                auto operation = std::make_unique<DeleteElementOperation>(record, std::move(deletedWires));
 
                 // 限制历史记录数量
                 if (undoStack.size() >= MAX_HISTORY) {
@@ -980,7 +1186,9 @@ public:
                 UpdateUndoRedoStatus();
 
                 // 从元素列表中移除
-                elements.erase(it);
+                simulator.Forget(pins);
+                EraseElement(it);
+                OnLocalTopologyChange(affectedPins);
 
                 // 清除选中状态
                 selectedElement = nullptr;
@@ -1072,12 +1280,12 @@ public:
         virtualPins.push_back(std::move(virtualPin));
 
         // 创建从引脚到虚拟引脚的连接
-        wires.push_back(std::make_unique<Wire>(startPin, virtualPinPtr));
+        AddWire(startPin, virtualPinPtr);
+        OnLocalTopologyChange({ virtualPinPtr });
 
         // 记录操作
         if (!isRestoringState) {
-            wxString serializedData = SerializeWire(wires.back().get());
-            auto operation = std::make_unique<AddWireOperation>(serializedData);
+            auto operation = std::make_unique<AddWireOperation>(MakeWireRef(wires.back().get()));
             undoStack.push_back(std::move(operation));
 
             if (undoStack.size() > MAX_HISTORY) {
@@ -1092,8 +1300,27 @@ public:
     }
 
 private:
+    // 引脚的引用：所在元件的稳定 ID 和引脚在 GetPins() 中的下标。虚拟引脚（导线连接点）不属于元件，element 为 0
+    struct PinRef {
+        uint32_t element;
+        uint32_t pin;
+    };
+
+    // 导线的引用：从输出引脚到输入引脚
+    struct WireRef {
+        PinRef start;
+        PinRef end;
+    };
+
+    // 删除的元件：稳定 ID 和序列化结果，撤销时以原 ID 重建
+    struct ElementRecord {
+        uint32_t id;
+        wxString data;
+    };
+
     // 复制粘贴相关成员变量
     std::vector<std::unique_ptr<CircuitElement>> clipboard;  // 剪贴板
+    std::vector<WireRef> clipboardWires;                     // 剪贴板元件之间的导线（元件为剪贴板下标）
     wxPoint pasteOffset;                                     // 粘贴偏移量
     int pasteCount;                                          // 粘贴计数
 
@@ -1104,72 +1331,207 @@ private:
     int connectionScrollPos;     // 连接信息滚动位置
     int maxConnectionWidth;      // 连接信息最大宽度
 
-    // 从序列化数据创建元件
-    std::unique_ptr<CircuitElement> CreateElementFromData(const wxString& data) {
-        wxStringTokenizer tokens(data, ",");
-        if (tokens.CountTokens() >= 3) {
-            long typeVal, x, y;
-            tokens.GetNextToken().ToLong(&typeVal);
-            tokens.GetNextToken().ToLong(&x);
-            tokens.GetNextToken().ToLong(&y);
-
-            ElementType type = static_cast<ElementType>(typeVal);
-            std::unique_ptr<CircuitElement> newElement;
-
-            // 根据类型创建相应的元件
-            if (type >= TYPE_AND && type <= TYPE_NOR) {
-                newElement = std::make_unique<Gate>(type, x, y);
-            }
-            else if (type == TYPE_INPUT || type == TYPE_OUTPUT) {
-                newElement = std::make_unique<InputOutput>(type, x, y);
-
-                // 处理输入输出的额外属性
-                if (tokens.HasMoreTokens()) {
-                    long value;
-                    tokens.GetNextToken().ToLong(&value);
-                    if (InputOutput* io = dynamic_cast<InputOutput*>(newElement.get())) {
-                        io->SetValue(value != 0);
-                    }
-                    if (tokens.HasMoreTokens()) {
-                        wxString name = tokens.GetNextToken();
-                        if (InputOutput* io = dynamic_cast<InputOutput*>(newElement.get())) {
-                            io->SetName(name);
-                        }
-                    }
-                }
+    // 文本电路的解析结果：元件行序号 -> 创建的元件（未创建的类型为空），以及读完元件后才连接的连接行和旧格式导线行
+    struct ParsedCircuitText {
+        std::vector<CircuitElement*> lineElements;
+        std::vector<CircuitTextReader::LinkLine> links;
+        std::vector<CircuitTextReader::WireLine> wireLines;
+    };
+
+    // 按电路文件的格式创建元件和导线（不清空现有内容）。ids 非空时第 i 个元件行的元件沿用 ids[i] 作为稳定 ID；
+    // 返回元件行序号 -> 创建的元件
+    std::vector<CircuitElement*> ParseCircuit(const wxString& data, const std::vector<uint32_t>* ids = nullptr) {
+        std::string text(data.utf8_str());
+        ReserveElements(std::count(text.begin(), text.end(), '\n') + 1);  // 行数是元件数的上界
+        ParsedCircuitText parsed;
+        CircuitTextReader reader;
+        reader.ReadText(text.data(), text.size(),
+            [this, &parsed, ids](const CircuitTextReader::ElementLine& line) { AddParsedElement(parsed, line, ids); },
+            [&parsed](const CircuitTextReader::WireLine& line) { parsed.wireLines.push_back(line); },
+            [&parsed](const CircuitTextReader::LinkLine& line) { parsed.links.push_back(line); });
+        ConnectParsedWires(parsed);
+        return parsed.lineElements;
+    }
+
+    // 按电路文件的一个元件行创建元件；只有有附加字段的类型才把整行转成 wxString 交给工厂反序列化
+    void AddParsedElement(ParsedCircuitText& parsed, const CircuitTextReader::ElementLine& line, const std::vector<uint32_t>* ids) {
+        ElementType type = static_cast<ElementType>(line.type);
+        uint32_t id = ids && line.index < ids->size() ? (*ids)[line.index] : 0;
+        CircuitElement* element = nullptr;
+        std::unique_ptr<CircuitElement> created = ElementFactory::NeedsData(type)
+            ? ElementFactory::Create(type, line.x, line.y, wxString::FromUTF8(line.line, line.lineLength))
+            : ElementFactory::Create(type, line.x, line.y);
+        if (created) element = InsertElement(std::move(created), id);
+        if (line.index >= parsed.lineElements.size()) parsed.lineElements.resize(line.index + 1, nullptr);
+        parsed.lineElements[line.index] = element;
+    }
+
+    // 连接读到的导线（输出引脚 -> 输入引脚）。连接行按元件行序号和引脚下标直接取引脚；
+    // 旧格式的导线行按坐标匹配，引脚坐标索引只建一次，查找结果与逐个元件比较坐标相同
+    void ConnectParsedWires(const ParsedCircuitText& parsed) {
+        wires.reserve(wires.size() + parsed.links.size() + parsed.wireLines.size());
+        const auto& lineElements = parsed.lineElements;
+        for (const CircuitTextReader::LinkLine& link : parsed.links) {
+            if (link.fromElement >= lineElements.size() || link.toElement >= lineElements.size() ||
+                !lineElements[link.fromElement] || !lineElements[link.toElement]) continue;
+            Pin* from = PinAt(lineElements[link.fromElement], link.fromPin);
+            Pin* to = PinAt(lineElements[link.toElement], link.toPin);
+            if (!from || !to || from->IsInput() == to->IsInput()) continue;
+            if (to->IsInput()) AddWire(from, to);
+            else AddWire(to, from);
+        }
+
+        if (parsed.wireLines.empty()) return;
+        CoordinateIndex index(CircuitFile::PIN_TOLERANCE);
+        std::vector<Pin*> pins;
+        for (auto& element : elements) {
+            for (Pin* pin : element->GetPins()) {
+                index.Add(pin->GetX(), pin->GetY());
+                pins.push_back(pin);
+            }
+        }
+        for (const CircuitTextReader::WireLine& line : parsed.wireLines) {
+            int a = index.Find(line.x1, line.y1);
+            int b = index.Find(line.x2, line.y2);
+            if (a < 0 || b < 0 || pins[a]->IsInput() == pins[b]->IsInput()) continue;
+            // 确保连接方向正确：输出引脚 -> 输入引脚
+            if (pins[b]->IsInput()) AddWire(pins[a], pins[b]);
+            else AddWire(pins[b], pins[a]);
+        }
+    }
+
+    // 按二进制电路文件创建元件和导线（不清空现有内容）。不需要附加字段的类型直接构造，
+    // 导线按元件下标和引脚下标连接，不按坐标查找引脚
+    void ParseBinaryCircuit(const BinaryCircuitReader& reader) {
+        std::vector<CircuitElement*> created(reader.GetElementCount(), nullptr);
+        std::vector<std::vector<Pin*>> pins(reader.GetElementCount());
+        ReserveElements(reader.GetElementCount());
+        for (uint32_t i = 0; i < reader.GetElementCount(); ++i) {
+            const BinaryElementRecord& record = reader.GetElement(i);
+            ElementType type = static_cast<ElementType>(record.type);
+            std::unique_ptr<CircuitElement> element;
+            if (!ElementFactory::NeedsData(type)) {
+                element = ElementFactory::Create(type, record.x, record.y);
             }
-            else if (type == TYPE_CLOCK) {
-                newElement = std::make_unique<ClockElement>(x, y);
-                if (tokens.HasMoreTokens()) {
-                    long freq;
-                    tokens.GetNextToken().ToLong(&freq);
-                    if (ClockElement* clock = dynamic_cast<ClockElement*>(newElement.get())) {
-                        clock->SetFrequency(freq);
-                    }
+            else {
+                wxString data = wxString::Format("%d,%d,%d", static_cast<int>(type), record.x, record.y);
+                if (record.attributeLength > 0) {
+                    data += "," + wxString::FromUTF8(reader.GetAttributes(i), record.attributeLength);
                 }
+                element = ElementFactory::Create(type, record.x, record.y, data);
             }
-            else if (type == TYPE_RS_FLIPFLOP) {
-                newElement = std::make_unique<RSFlipFlop>(x, y);
-            }
-            else if (type == TYPE_D_FLIPFLOP) {
-                newElement = std::make_unique<DFlipFlop>(x, y);
-            }
-            else if (type == TYPE_JK_FLIPFLOP) {
-                newElement = std::make_unique<JKFlipFlop>(x, y);
+            if (!element) continue;
+            created[i] = InsertElement(std::move(element));
+            pins[i] = created[i]->GetPins();
+        }
+
+        for (uint32_t i = 0; i < reader.GetWireCount(); ++i) {
+            const BinaryWireRecord& wire = reader.GetWire(i);
+            const auto& driverPins = pins[wire.driverElement];
+            const auto& readerPins = pins[wire.readerElement];
+            if (wire.driverPin >= driverPins.size() || wire.readerPin >= readerPins.size()) continue;
+            Pin* from = driverPins[wire.driverPin];
+            Pin* to = readerPins[wire.readerPin];
+            if (from->IsInput() || !to->IsInput()) continue;
+            AddWire(from, to);
+        }
+    }
+
+    // 保存用的快照：元件的附加字段与文本格式相同（门没有附加字段，不经过 Serialize），导线记录两端的元件下标和引脚下标。
+    // 连接到导线连接点（虚拟引脚）的导线与 SerializeCircuit 一样不保存
+    std::shared_ptr<const CircuitSnapshot> TakeSaveSnapshot() const {
+        auto snapshot = std::make_shared<CircuitSnapshot>();
+        snapshot->Reserve(elements.size(), wires.size());
+        std::vector<uint32_t> index(elementById.size(), 0);  // 稳定 ID -> 快照中的元件下标
+        uint32_t next = 0;
+        for (auto& element : elements) {
+            ElementType type = element->GetType();
+            bool value = false;
+            if (type == TYPE_INPUT || type == TYPE_OUTPUT) {
+                value = static_cast<const InputOutput*>(element.get())->GetValue();
             }
-            else if (type == TYPE_T_FLIPFLOP) {
-                newElement = std::make_unique<TFlipFlop>(x, y);
+            index[element->GetId()] = next++;
+            snapshot->AddElement(type, element->GetX(), element->GetY(), value,
+                ElementFactory::NeedsData(type) ? NetlistBuilder::SerializedAttributes(element.get()) : std::string());
+        }
+
+        for (auto& wire : wires) {
+            WireRef ref = MakeWireRef(wire.get());
+            if (ref.start.element == 0 || ref.end.element == 0) continue;
+            snapshot->AddWire(index[ref.start.element], static_cast<uint16_t>(ref.start.pin),
+                index[ref.end.element], static_cast<uint16_t>(ref.end.pin));
+        }
+        return snapshot;
+    }
+
+    // 把当前电路的快照交给保存线程，带上当前的编辑标记；保存成功后直到下一次编辑都不需要自动保存
+    void SubmitSave(const wxString& filename, bool autosave) {
+        saveThread.Submit(TakeSaveSnapshot(), std::string(filename.utf8_str()), autosave, GetEditMarker());
+        if (!saveTimer.IsRunning()) saveTimer.Start(SAVE_POLL_MS);
+    }
+
+    // 报告已完成的保存：成功时在状态栏显示并记下保存的编辑标记，自动保存失败只写状态栏（下个周期重试），
+    // 手动保存失败弹出提示。有手动保存失败时返回 false
+    bool ReportSaveResults() {
+        std::vector<SaveThread::Result> results;
+        if (!saveThread.TakeResults(results)) return true;
+
+        wxWindow* topWindow = wxGetTopLevelParent(this);
+        wxStatusBar* statusBar = nullptr;
+        if (topWindow && topWindow->IsKindOf(CLASSINFO(wxFrame))) {
+            statusBar = static_cast<wxFrame*>(topWindow)->GetStatusBar();
+        }
+        bool saved = true;
+        for (const SaveThread::Result& result : results) {
+            if (result.ok) {
+                autosaveMarker = result.tag;
+                if (statusBar) {
+                    statusBar->SetStatusText(wxString::Format("%s (%.1f MB, %.2f s)",
+                        result.autosave ? "Circuit autosaved" : "Circuit saved successfully", result.bytes / 1e6, result.seconds));
+                }
             }
-            else if (type == TYPE_REGISTER) {
-                newElement = std::make_unique<RegisterElement>(x, y);
+            else if (result.autosave) {
+                if (statusBar) statusBar->SetStatusText("Autosave failed: " + wxString::FromUTF8(result.error.c_str()));
             }
-
-            if (newElement) {
-                newElement->Deserialize(data);
-                return newElement;
+            else {
+                saved = false;
+                wxMessageBox("Failed to save circuit file: " + wxString::FromUTF8(result.error.c_str()), "Error", wxOK | wxICON_ERROR, this);
             }
         }
-        return nullptr;
+        return saved;
+    }
+
+    // 撤销栈顶操作的序号：有新的编辑时变化，撤销/重做回到同一状态时相同
+    uint64_t GetEditMarker() const {
+        return undoStack.empty() ? 0 : undoStack.back()->GetSerial();
+    }
+
+    // 不记录历史地把画布内容换成 data 描述的电路。ids 为空时记录新分配的各元件行的稳定 ID，
+    // 否则元件沿用其中的 ID（撤销栈中的其他记录按 ID 引用这些元件）
+    void RestoreCircuitWithoutHistory(const wxString& data, std::vector<uint32_t>& ids) {
+        // 被观察的输出按稳定 ID 记下，重建后重新绑定：元件对象全部重建，旧指针可能与新元件的地址相同
+        std::vector<uint32_t> watchedIds;
+        for (CircuitElement* output : watchedOutputs) watchedIds.push_back(output->GetId());
+        watchedOutputs.clear();
+        elements.clear();
+        std::fill(elementById.begin(), elementById.end(), nullptr);
+        netGraph.Clear();
+        wires.clear();
+        virtualPins.clear();
+        selectedElement = nullptr;
+        selectedWire = nullptr;
+        startPin = nullptr;
+        std::vector<CircuitElement*> created = ParseCircuit(data, ids.empty() ? nullptr : &ids);
+        if (ids.empty()) {
+            for (CircuitElement* element : created) ids.push_back(element ? element->GetId() : 0);
+        }
+        for (uint32_t id : watchedIds) {
+            CircuitElement* element = FindElementById(id);
+            if (element && element->GetType() == TYPE_OUTPUT) watchedOutputs.push_back(element);
+        }
+        simulator.SetCone(watchedOutputs);
+        OnTopologyChanged();
+        UpdateCircuit();
     }
 
     // === 操作系统 ===
@@ -1179,140 +1541,170 @@ private:
         OP_ADD_WIRE,
         OP_DELETE_WIRE,
         OP_MOVE_ELEMENT,
-        OP_CHANGE_VALUE
+        OP_CHANGE_VALUE,
+        OP_REPLACE_CIRCUIT
     };
 
     // 操作基类，定义撤销/重做接口
     class Operation {
     public:
-        Operation(OperationType type) : type(type) {}
+        Operation(OperationType type) : type(type), serial(NextSerial()) {}
         virtual ~Operation() {}
         virtual void Execute(CircuitCanvas* canvas) = 0;  // 执行操作
         virtual void Undo(CircuitCanvas* canvas) = 0;     // 撤销操作
         OperationType GetType() const { return type; }
+        uint64_t GetSerial() const { return serial; }     // 创建顺序，自动保存据此判断电路是否有修改
     private:
+        static uint64_t NextSerial() {
+            static uint64_t counter = 0;
+            return ++counter;
+        }
+
         OperationType type;
+        uint64_t serial;
     };
 
-    // 添加元件操作
+    // 添加元件操作：按稳定 ID 撤销，重做时以同一 ID 重建，之后的操作仍能引用它
     class AddElementOperation : public Operation {
     public:
-        AddElementOperation(const wxString& serializedData)
-            : Operation(OP_ADD_ELEMENT), serializedData(serializedData) {
+        AddElementOperation(const wxString& serializedData, uint32_t id)
+            : Operation(OP_ADD_ELEMENT), serializedData(serializedData), id(id) {
         }
 
         virtual void Execute(CircuitCanvas* canvas) override {
-            canvas->RestoreElementFromSerializedData(serializedData);
+            canvas->RestoreElementFromSerializedData(serializedData, id);
         }
 
         virtual void Undo(CircuitCanvas* canvas) override {
-            // 找到并删除最后添加的元件（就是我们刚刚重做添加的那个）
-            if (!canvas->elements.empty()) {
-                CircuitElement* elementToRemove = canvas->elements.back().get();
-                canvas->RemoveElementWithoutHistory(elementToRemove);
-            }
+            canvas->RemoveElementWithoutHistory(canvas->FindElementById(id));
         }
 
     private:
         wxString serializedData;
+        uint32_t id;
     };
 
-    // 添加导线操作
+    // 添加导线操作：按两端引脚的引用重做和撤销
     class AddWireOperation : public Operation {
     public:
-        AddWireOperation(const wxString& serializedData)
-            : Operation(OP_ADD_WIRE), serializedData(serializedData) {
+        AddWireOperation(const WireRef& wire)
+            : Operation(OP_ADD_WIRE), wire(wire) {
         }
 
         virtual void Execute(CircuitCanvas* canvas) override {
-            canvas->RestoreWireFromSerializedData(serializedData);
+            canvas->RestoreWire(wire);
         }
 
         virtual void Undo(CircuitCanvas* canvas) override {
-            // 找到并删除最后添加的导线
-            if (!canvas->wires.empty()) {
-                Wire* wireToRemove = canvas->wires.back().get();
-                canvas->RemoveWireWithoutHistory(wireToRemove);
+            Wire* wireToRemove = canvas->FindWire(wire);
+            // 连接到导线连接点的导线没有引用，仍按最后添加的导线撤销
+            if (!wireToRemove && (wire.start.element == 0 || wire.end.element == 0) && !canvas->wires.empty()) {
+                wireToRemove = canvas->wires.back().get();
             }
+            if (wireToRemove) canvas->RemoveWireWithoutHistory(wireToRemove);
         }
 
     private:
-        wxString serializedData;
+        WireRef wire;
     };
 
-    // 批量删除操作
+    // 批量删除操作：撤销时以原 ID 重建元件，再恢复随元件删除的导线
     class BatchDeleteOperation : public Operation {
     public:
-        BatchDeleteOperation(std::vector<std::pair<std::unique_ptr<CircuitElement>, wxString>> elements)
-            : Operation(OP_DELETE_ELEMENT), elements(std::move(elements)) {
+        BatchDeleteOperation(std::vector<ElementRecord> elements, std::vector<WireRef> wires)
+            : Operation(OP_DELETE_ELEMENT), elements(std::move(elements)), wires(std::move(wires)) {
         }
 
         virtual void Execute(CircuitCanvas* canvas) override {
             // 重做删除操作：再次删除
             for (auto& element : elements) {
-                if (element.first) {
-                    canvas->RemoveElementWithoutHistory(element.first.get());
-                }
+                canvas->RemoveElementWithoutHistory(canvas->FindElementById(element.id));
             }
         }
 
         virtual void Undo(CircuitCanvas* canvas) override {
-            // 撤销删除操作：恢复所有元件
+            // 撤销删除操作：恢复所有元件和导线
             for (auto& element : elements) {
-                canvas->RestoreElementFromSerializedData(element.second);
+                canvas->RestoreElementFromSerializedData(element.data, element.id);
+            }
+            for (auto& wire : wires) {
+                canvas->RestoreWire(wire);
             }
         }
 
     private:
-        std::vector<std::pair<std::unique_ptr<CircuitElement>, wxString>> elements;
+        std::vector<ElementRecord> elements;
+        std::vector<WireRef> wires;
     };
 
     // 删除元件操作
     class DeleteElementOperation : public Operation {
     public:
-        DeleteElementOperation(std::unique_ptr<CircuitElement> element, const wxString& serializedData)
-            : Operation(OP_DELETE_ELEMENT), element(std::move(element)), serializedData(serializedData) {
+        DeleteElementOperation(const ElementRecord& element, std::vector<WireRef> wires)
+            : Operation(OP_DELETE_ELEMENT), element(element), wires(std::move(wires)) {
         }
 
         virtual void Execute(CircuitCanvas* canvas) override {
             // 重做删除操作：再次删除
-            if (element) {
-                canvas->RemoveElementWithoutHistory(element.get());
-            }
+            canvas->RemoveElementWithoutHistory(canvas->FindElementById(element.id));
         }
 
         virtual void Undo(CircuitCanvas* canvas) override {
-            // 撤销删除操作：恢复元件
-            canvas->RestoreElementFromSerializedData(serializedData);
+            // 撤销删除操作：恢复元件和连接到它的导线
+            canvas->RestoreElementFromSerializedData(element.data, element.id);
+            for (auto& wire : wires) {
+                canvas->RestoreWire(wire);
+            }
         }
 
     private:
-        std::unique_ptr<CircuitElement> element;
-        wxString serializedData;
+        ElementRecord element;
+        std::vector<WireRef> wires;
     };
 
     // 删除导线操作
     class DeleteWireOperation : public Operation {
     public:
-        DeleteWireOperation(std::unique_ptr<Wire> wire, const wxString& serializedData)
-            : Operation(OP_DELETE_WIRE), wire(std::move(wire)), serializedData(serializedData) {
+        DeleteWireOperation(const WireRef& wire)
+            : Operation(OP_DELETE_WIRE), wire(wire) {
         }
 
         virtual void Execute(CircuitCanvas* canvas) override {
             // 重做删除操作：再次删除
-            if (wire) {
-                canvas->RemoveWireWithoutHistory(wire.get());
+            if (Wire* wireToRemove = canvas->FindWire(wire)) {
+                canvas->RemoveWireWithoutHistory(wireToRemove);
             }
         }
 
         virtual void Undo(CircuitCanvas* canvas) override {
             // 撤销删除操作：恢复导线
-            canvas->RestoreWireFromSerializedData(serializedData);
+            canvas->RestoreWire(wire);
         }
 
     private:
-        std::unique_ptr<Wire> wire;
-        wxString serializedData;
+        WireRef wire;
+    };
+
+    // 整个电路替换操作：保存替换前后的文本形式和各元件行的稳定 ID，恢复后的元件沿用原来的 ID
+    class ReplaceCircuitOperation : public Operation {
+    public:
+        ReplaceCircuitOperation(const wxString& before, std::vector<uint32_t> beforeIds, const wxString& after)
+            : Operation(OP_REPLACE_CIRCUIT), before(before), after(after), beforeIds(std::move(beforeIds)) {
+        }
+
+        virtual void Execute(CircuitCanvas* canvas) override {
+            canvas->RestoreCircuitWithoutHistory(after, afterIds);
+        }
+
+        virtual void Undo(CircuitCanvas* canvas) override {
+            canvas->RestoreCircuitWithoutHistory(before, beforeIds);
+        }
+
+    private:
+        wxString before;
+        wxString after;
+        std::vector<uint32_t> beforeIds;
+        std::vector<uint32_t> afterIds;  // 第一次执行时分配
     };
 
     // === 撤销/重做系统 ===
@@ -1330,23 +1722,16 @@ private:
         return data;
     }
 
-    // 序列化导线
-    wxString SerializeWire(Wire* wire) {
-        wxString data;
-        wire->Serialize(data);
-        return data;
-    }
-
-    // 从序列化数据恢复元件
-    void RestoreElementFromSerializedData(const wxString& data) {
-        CreateElementFromSerializedData(data);
+    // 从序列化数据恢复元件，沿用原来的稳定 ID
+    void RestoreElementFromSerializedData(const wxString& data, uint32_t id) {
+        CreateElementFromSerializedData(data, id);
         UpdateCircuit();
         Refresh();
     }
 
-    // 从序列化数据恢复导线
-    void RestoreWireFromSerializedData(const wxString& data) {
-        CreateWireFromSerializedData(data);
+    // 按引用恢复导线
+    void RestoreWire(const WireRef& ref) {
+        CreateWireFromRef(ref);
         UpdateCircuit();
         Refresh();
     }
@@ -1357,8 +1742,9 @@ private:
 
         isRestoringState = true;
 
-        // 安全地删除与元件引脚相连的所有导线
+        // 安全地删除与元件引脚相连的所有导线；另一端的输入引脚需要重新取值
         auto pins = element->GetPins();
+        std::vector<Pin*> affectedPins;
         for (auto pin : pins) {
             // 使用临时向量收集要删除的导线，避免迭代器失效
             std::vector<Wire*> wiresToRemove;
@@ -1375,12 +1761,13 @@ private:
                         return w.get() == wireToRemove;
                     });
                 if (it != wires.end()) {
+                    // 自环导线的读取引脚属于被删除的元件，不能再作为传播起点
+                    Pin* endPin = (*it)->GetEndPin();
+                    if (endPin->GetParent() != element) affectedPins.push_back(endPin);
+                    netGraph.RemoveWire(it->get());
                     wires.erase(it);
                 }
             }
-
-            // 清除引脚连接
-            pin->SetConnectedWire(nullptr);
         }
 
         // 安全地删除元件
@@ -1389,9 +1776,11 @@ private:
                 return elem.get() == element;
             });
 
+        simulator.Forget(pins);
         if (it != elements.end()) {
-            elements.erase(it);
+            EraseElement(it);
         }
+        OnLocalTopologyChange(affectedPins);
 
         // 清除选中状态
         if (selectedElement == element) {
@@ -1413,6 +1802,9 @@ private:
             });
 
         if (it != wires.end()) {
+            // 读取端改为读取其他线网（若有）的值
+            std::vector<Pin*> affectedPins{ wire->GetEndPin() };
+
             // 如果导线包含虚拟引脚，也需要清理虚拟引脚
             if (wire->HasVirtualPin()) {
                 Pin* startPin = wire->GetStartPin();
@@ -1425,6 +1817,7 @@ private:
                             return p.get() == startPin;
                         });
                     if (pinIt != virtualPins.end()) {
+                        simulator.Forget({ startPin });
                         virtualPins.erase(pinIt);
                     }
                 }
@@ -1434,12 +1827,16 @@ private:
                             return p.get() == endPin;
                         });
                     if (pinIt != virtualPins.end()) {
+                        simulator.Forget({ endPin });
+                        affectedPins.clear();
                         virtualPins.erase(pinIt);
                     }
                 }
             }
 
+            netGraph.RemoveWire(it->get());
             wires.erase(it);
+            OnLocalTopologyChange(affectedPins);
         }
 
         isRestoringState = false;
@@ -1454,13 +1851,12 @@ private:
             Pin* inputPin = startPin->IsInput() ? startPin : endPin;
 
             // 创建导线
-            wires.push_back(std::make_unique<Wire>(outputPin, inputPin));
-            Wire* wirePtr = wires.back().get();
+            Wire* wirePtr = AddWire(outputPin, inputPin);
+            OnLocalTopologyChange({ inputPin });
 
             // 记录添加导线操作
             if (!isRestoringState) {
-                wxString serializedData = SerializeWire(wirePtr);
-                auto operation = std::make_unique<AddWireOperation>(serializedData);
+                auto operation = std::make_unique<AddWireOperation>(MakeWireRef(wirePtr));
                 undoStack.push_back(std::move(operation));
 
                 // 限制历史记录数量
@@ -1477,119 +1873,362 @@ private:
         this->startPin = nullptr;
     }
 
-    // 从序列化数据创建元件
-    void CreateElementFromSerializedData(const wxString& data) {
-        wxStringTokenizer tokens(data, ",");
-        if (tokens.CountTokens() >= 3) {
-            long typeVal, x, y;
-            tokens.GetNextToken().ToLong(&typeVal);
-            tokens.GetNextToken().ToLong(&x);
-            tokens.GetNextToken().ToLong(&y);
+    // 从序列化数据创建元件；id 非 0 时沿用该稳定 ID
+    void CreateElementFromSerializedData(const wxString& data, uint32_t id = 0) {
+        std::unique_ptr<CircuitElement> newElement = ElementFactory::CreateFromData(data);
+        if (newElement) {
+            CircuitElement* elementPtr = InsertElement(std::move(newElement), id);
+            OnLocalTopologyChange(elementPtr->GetPins());
+        }
+    }
 
-            ElementType type = static_cast<ElementType>(typeVal);
-            std::unique_ptr<CircuitElement> newElement;
+    // 按引用创建导线：两端引脚由元件 ID 直接取得，不按坐标查找
+    void CreateWireFromRef(const WireRef& ref) {
+        Pin* startPin = ResolvePin(ref.start);
+        Pin* endPin = ResolvePin(ref.end);
+        if (!startPin || !endPin || startPin->IsInput() || !endPin->IsInput()) return;
+        AddWire(startPin, endPin);
+        OnLocalTopologyChange({ endPin });
+    }
 
-            // 根据类型创建相应的元件
-            if (type >= TYPE_AND && type <= TYPE_NOR) {
-                newElement = std::make_unique<Gate>(type, x, y);
-            }
-            else if (type == TYPE_INPUT || type == TYPE_OUTPUT) {
-                newElement = std::make_unique<InputOutput>(type, x, y);
+    // 把元件加入画布并登记稳定 ID。id 为 0 或已被占用时分配新的 ID；ID 不重复使用，
+    // 撤销栈中引用已删除元件的记录在元件以原 ID 恢复后仍然有效
+    CircuitElement* InsertElement(std::unique_ptr<CircuitElement> element, uint32_t id = 0) {
+        if (elementById.empty()) elementById.push_back(nullptr);  // ID 0 表示没有元件
+        if (id == 0 || (id < elementById.size() && elementById[id])) id = static_cast<uint32_t>(elementById.size());
+        if (id >= elementById.size()) elementById.resize(id + 1, nullptr);
+        element->SetId(id);
+        elementById[id] = element.get();
+        elements.push_back(std::move(element));
+        return elements.back().get();
+    }
 
-                // 处理输入输出的额外属性
-                if (tokens.HasMoreTokens()) {
-                    long value;
-                    tokens.GetNextToken().ToLong(&value);
-                    if (InputOutput* io = dynamic_cast<InputOutput*>(newElement.get())) {
-                        io->SetValue(value != 0);
-                    }
-                    if (tokens.HasMoreTokens()) {
-                        wxString name = tokens.GetNextToken();
-                        if (InputOutput* io = dynamic_cast<InputOutput*>(newElement.get())) {
-                            io->SetName(name);
-                        }
-                    }
+    // 批量加入元件前一次预留元件列表和 ID 表的容量，避免逐个追加时反复扩容
+    void ReserveElements(size_t count) {
+        elements.reserve(elements.size() + count);
+        elementById.reserve(std::max<size_t>(elementById.size(), 1) + count);
+    }
+
+    // 从元件列表中移除元件并注销其 ID
+    void EraseElement(std::vector<std::unique_ptr<CircuitElement>>::iterator it) {
+        uint32_t id = (*it)->GetId();
+        if (id < elementById.size()) elementById[id] = nullptr;
+        elements.erase(it);
+    }
+
+    CircuitElement* FindElementById(uint32_t id) const {
+        return id < elementById.size() ? elementById[id] : nullptr;
+    }
+
+    // 元件的第 index 个引脚（GetPins() 的顺序）
+    static Pin* PinAt(CircuitElement* element, uint32_t index) {
+        auto pins = element->GetPins();
+        return index < pins.size() ? pins[index] : nullptr;
+    }
+
+    PinRef MakePinRef(Pin* pin) const {
+        CircuitElement* element = pin ? pin->GetParent() : nullptr;
+        if (!element || pin->IsVirtual()) return PinRef{ 0, 0 };
+        auto pins = element->GetPins();
+        return PinRef{ element->GetId(), static_cast<uint32_t>(std::find(pins.begin(), pins.end(), pin) - pins.begin()) };
+    }
+
+    WireRef MakeWireRef(const Wire* wire) const {
+        return WireRef{ MakePinRef(wire->GetStartPin()), MakePinRef(wire->GetEndPin()) };
+    }
+
+    Pin* ResolvePin(const PinRef& ref) const {
+        CircuitElement* element = FindElementById(ref.element);
+        return element ? PinAt(element, ref.pin) : nullptr;
+    }
+
+    // 引用所指的导线：在起点所在线网的导线中查找
+    Wire* FindWire(const WireRef& ref) const {
+        Pin* startPin = ResolvePin(ref.start);
+        Pin* endPin = ResolvePin(ref.end);
+        if (!startPin || !endPin || startPin->GetNet() < 0) return nullptr;
+        for (Wire* wire : netGraph.GetWires(startPin->GetNet())) {
+            if (wire->GetStartPin() == startPin && wire->GetEndPin() == endPin) return wire;
+        }
+        return nullptr;
+    }
+
+    // 创建导线并登记到线网图
+    Wire* AddWire(Pin* start, Pin* end) {
+        wires.push_back(std::make_unique<Wire>(start, end));
+        netGraph.AddWire(wires.back().get());
+        return wires.back().get();
+    }
+
+    // 电路整体改变（加载、清空、批量编辑等）后调用，使依赖电路结构的缓存失效，下次仿真重新求值所有元件
+    void OnTopologyChanged() {
+        simulator.Invalidate();
+        InvalidateStructuralCaches();
+    }
+
+    // 单个元件或导线增删后调用：事件驱动仿真只从 pins（新元件的引脚、连接或断开的读取引脚）
+    // 沿扇出重新传播，其余缓存与 OnTopologyChanged 相同地失效
+    void OnLocalTopologyChange(const std::vector<Pin*>& pins) {
+        simulator.InvalidateLocal(pins);
+        InvalidateStructuralCaches();
+    }
+
+    // 使仿真内核以外依赖电路结构的缓存失效
+    void InvalidateStructuralCaches() {
+        if (!watchedOutputs.empty()) {
+            // 已删除的输出不再观察
+            auto removed = [this](CircuitElement* output) {
+                return std::none_of(elements.begin(), elements.end(),
+                    [output](const std::unique_ptr<CircuitElement>& element) { return element.get() == output; });
+            };
+            size_t watchedCount = watchedOutputs.size();
+            watchedOutputs.erase(std::remove_if(watchedOutputs.begin(), watchedOutputs.end(), removed),
+                watchedOutputs.end());
+            if (watchedOutputs.size() != watchedCount) simulator.SetCone(watchedOutputs);
+        }
+        compiledDirty = true;
+        sequentialDirty = true;
+        backgroundRestart = backgroundSimulation.IsRunning();
+        structuralHashDirty = true;
+    }
+
+    // 按需重新构建网表并编译
+    void EnsureCompiled() {
+        if (!compiledDirty) return;
+        compiledDirty = false;
+
+        Netlist netlist;
+        NetlistBuilder::Build(elements, wires, netlist, &compiledBinding);
+        compiledInputs.clear();
+        compiledOutputs.clear();
+        if (compiledCircuit.Compile(netlist)) {
+            for (auto element : compiledBinding.elements) {
+                if (element->GetType() == TYPE_INPUT) {
+                    compiledInputs.push_back(static_cast<InputOutput*>(element));
                 }
-            }
-            else if (type == TYPE_CLOCK) {
-                newElement = std::make_unique<ClockElement>(x, y);
-                if (tokens.HasMoreTokens()) {
-                    long freq;
-                    tokens.GetNextToken().ToLong(&freq);
-                    if (ClockElement* clock = dynamic_cast<ClockElement*>(newElement.get())) {
-                        clock->SetFrequency(freq);
-                    }
+                else if (element->GetType() == TYPE_OUTPUT) {
+                    compiledOutputs.push_back(static_cast<InputOutput*>(element));
                 }
             }
-            else if (type == TYPE_RS_FLIPFLOP) {  // 新增RS触发器
-                newElement = std::make_unique<RSFlipFlop>(x, y);
-            }
-            else if (type == TYPE_D_FLIPFLOP) {
-                newElement = std::make_unique<DFlipFlop>(x, y);
+            compiledValues.assign(compiledCircuit.GetSlotCount(), 0);
+            ExtractWatchedCone();
+            PrepareIncremental();
+        }
+        compiledValuesValid = false;
+    }
+
+    // 为增量求值准备扇出表，并把需要写回的引脚按槽位分组
+    void PrepareIncremental() {
+        const bool coneOnly = compiledCone.IsValid();
+        incrementalEvaluator.Prepare(coneOnly ? compiledCone : compiledCircuit);
+        const auto& pins = coneOnly ? conePins : compiledBinding.pins;
+        slotPinOffsets.assign(compiledCircuit.GetSlotCount() + 1, 0);
+        for (auto& entry : pins) slotPinOffsets[entry.second + 1]++;
+        for (size_t s = 0; s < compiledCircuit.GetSlotCount(); ++s) slotPinOffsets[s + 1] += slotPinOffsets[s];
+        slotPins.assign(pins.size(), nullptr);
+        std::vector<uint32_t> cursor(slotPinOffsets.begin(), slotPinOffsets.end() - 1);
+        for (auto& entry : pins) slotPins[cursor[entry.second]++] = entry.first;
+    }
+
+    // 提取被观察输出的扇入锥，以及需要写回的引脚（读取锥中线网的引脚）
+    void ExtractWatchedCone() {
+        compiledCone = CompiledCircuit();
+        conePins.clear();
+        coneOutputs.clear();
+        std::vector<int> watched = GetWatchedOutputIndices();
+        if (watched.empty()) return;
+
+        compiledCircuit.ExtractCone(watched, compiledCone);
+        std::vector<bool> inCone(compiledCircuit.GetSlotCount(), false);
+        inCone[Netlist::CONST_ZERO_NET] = true;
+        for (uint32_t slot : compiledCone.GetInputSlots()) inCone[slot] = true;
+        for (const GateInstruction& instr : compiledCone.GetProgram()) inCone[instr.out] = true;
+        for (auto& entry : compiledBinding.pins) {
+            if (inCone[entry.second]) conePins.push_back(entry);
+        }
+        for (int o : watched) coneOutputs.push_back(compiledOutputs[o]);
+    }
+
+    // 用编译后的指令流求值并把结果写回引脚；电路无法编译时返回 false
+    bool RunCompiled() {
+        EnsureCompiled();
+        if (!compiledCircuit.IsValid()) return false;
+
+        // 设置了被观察的输出时只求值和写回它们的扇入锥
+        const bool coneOnly = compiledCone.IsValid();
+        const CompiledCircuit& circuit = coneOnly ? compiledCone : compiledCircuit;
+        const auto& inputSlots = circuit.GetInputSlots();
+        if (compiledValuesValid) return RunCompiledIncremental(circuit);
+
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            compiledValues[inputSlots[i]] = compiledInputs[i]->GetValue() ? 0xFF : 0x00;
+        }
+        if (parallelEvaluation) {
+            parallelEvaluator.Evaluate(circuit, compiledValues.data());
+        }
+        else {
+            circuit.Evaluate(compiledValues.data());
+        }
+
+        size_t changedPins = 0;
+        for (auto& entry : coneOnly ? conePins : compiledBinding.pins) {
+            bool value = compiledValues[entry.second] != 0;
+            if (entry.first->GetValue() != value) changedPins++;
+            entry.first->SetValue(value);
+        }
+        const auto& outputSlots = circuit.GetOutputSlots();
+        const auto& outputs = coneOnly ? coneOutputs : compiledOutputs;
+        for (size_t i = 0; i < outputSlots.size(); ++i) {
+            outputs[i]->SetValue(compiledValues[outputSlots[i]] != 0);
+        }
+
+        // 无环电路按层求值一遍即为不动点
+        lastSimulationResult = SimulationResult();
+        lastSimulationResult.eventsProcessed = circuit.GetProgram().size();
+        lastSimulationResult.iterations = circuit.GetLevelCount();
+        lastSimulationResult.changedPins = changedPins;
+        compiledValuesValid = true;
+        return true;
+    }
+
+    // 上次求值的槽位值仍有效时，只从值改变的输入出发沿扇出锥求值，并只写回值改变的槽位上的引脚
+    bool RunCompiledIncremental(const CompiledCircuit& circuit) {
+        const auto& inputSlots = circuit.GetInputSlots();
+        changedSlots.clear();
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            uint8_t value = compiledInputs[i]->GetValue() ? 0xFF : 0x00;
+            if (compiledValues[inputSlots[i]] == value) continue;
+            compiledValues[inputSlots[i]] = value;
+            changedSlots.push_back(inputSlots[i]);
+        }
+        incrementalEvaluator.Propagate(circuit, compiledValues.data(), changedSlots);
+
+        size_t changedPins = 0;
+        for (uint32_t slot : changedSlots) {
+            bool value = compiledValues[slot] != 0;
+            for (uint32_t k = slotPinOffsets[slot]; k < slotPinOffsets[slot + 1]; ++k) {
+                if (slotPins[k]->GetValue() != value) changedPins++;
+                slotPins[k]->SetValue(value);
             }
-            else if (type == TYPE_JK_FLIPFLOP) {
-                newElement = std::make_unique<JKFlipFlop>(x, y);
+        }
+        if (!changedSlots.empty()) {
+            const auto& outputSlots = circuit.GetOutputSlots();
+            const auto& outputs = compiledCone.IsValid() ? coneOutputs : compiledOutputs;
+            for (size_t i = 0; i < outputSlots.size(); ++i) {
+                outputs[i]->SetValue(compiledValues[outputSlots[i]] != 0);
             }
-            else if (type == TYPE_T_FLIPFLOP) {
-                newElement = std::make_unique<TFlipFlop>(x, y);
+        }
+
+        lastSimulationResult = SimulationResult();
+        lastSimulationResult.eventsProcessed = incrementalEvaluator.GetEvaluatedCount();
+        lastSimulationResult.iterations = changedSlots.empty() ? 0 : 1;
+        lastSimulationResult.changedPins = changedPins;
+        return true;
+    }
+
+    // 按需编译时序电路，并以画布上的当前值为起点：输入值和元件状态可能在两次运行之间被修改。
+    // 组合部分有环时返回 false
+    bool PrepareSequential() {
+        if (sequentialDirty) {
+            sequentialDirty = false;
+            Netlist netlist;
+            NetlistBuilder::Build(elements, wires, netlist, &sequentialBinding);
+            sequentialCircuit.Compile(netlist);
+        }
+        if (!sequentialCircuit.IsValid()) return false;
+
+        size_t input = 0;
+        for (size_t i = 0; i < sequentialBinding.elements.size(); ++i) {
+            CircuitElement* element = sequentialBinding.elements[i];
+            if (element->GetType() == TYPE_INPUT) {
+                sequentialCircuit.SetInput(input++, static_cast<InputOutput*>(element)->GetValue());
             }
-            else if (type == TYPE_REGISTER) {
-                newElement = std::make_unique<RegisterElement>(x, y);
+            else if (sequentialCircuit.HasState(static_cast<int>(i))) {
+                sequentialCircuit.SetState(static_cast<int>(i), element->GetStateBits());
             }
+        }
+        sequentialCircuit.Settle();
+        return true;
+    }
 
-            if (newElement) {
-                elements.push_back(std::move(newElement));
+    // 把快照中的线网值和元件状态写回画布，返回值发生变化的引脚数
+    size_t ApplySequentialSnapshot(const SequentialSnapshot& snapshot) {
+        size_t changedPins = 0;
+        for (auto& entry : sequentialBinding.pins) {
+            bool value = snapshot.values[entry.second] != 0;
+            if (entry.first->GetValue() != value) changedPins++;
+            entry.first->SetValue(value);
+        }
+        for (size_t i = 0; i < sequentialBinding.elements.size(); ++i) {
+            CircuitElement* element = sequentialBinding.elements[i];
+            if (element->GetType() == TYPE_OUTPUT) {
+                element->Update();
+            }
+            else if (CompiledCircuit::IsSequential(element->GetType())) {
+                element->SetStateBits(snapshot.states[i]);
             }
         }
+        return changedPins;
+    }
+
+    // 取走已停止的后台线程的最后快照。电路结构在线程运行期间被修改（删除、清空、加载、撤销）时，
+    // sequentialBinding 中的元件和引脚可能已经释放，丢弃快照，由 PrepareSequential 按画布当前状态重建
+    void TakeFinalBackgroundSnapshot() {
+        if (!backgroundSimulation.TakeSnapshot(sequentialSnapshot)) return;
+        if (!sequentialDirty) ApplySequentialSnapshot(sequentialSnapshot);
     }
 
-    // 从序列化数据创建导线
-    void CreateWireFromSerializedData(const wxString& data) {
-        wxStringTokenizer tokens(data, ",");
-        tokens.GetNextToken(); // 跳过 "WIRE"
+    // 在界面线程上按周期推进 steps 步并写回画布
+    bool RunSequential(size_t steps) {
+        if (!PrepareSequential()) return false;
+        size_t transitions = sequentialCircuit.Run(steps);
+        sequentialCircuit.Capture(sequentialSnapshot);
 
-        if (tokens.CountTokens() >= 6) {
-            long startX, startY, startIsInput, endX, endY, endIsInput;
-            tokens.GetNextToken().ToLong(&startX);
-            tokens.GetNextToken().ToLong(&startY);
-            tokens.GetNextToken().ToLong(&startIsInput);
-            tokens.GetNextToken().ToLong(&endX);
-            tokens.GetNextToken().ToLong(&endY);
-            tokens.GetNextToken().ToLong(&endIsInput);
+        lastSimulationResult = SimulationResult();
+        lastSimulationResult.eventsProcessed = transitions;  // 时序元件的状态变化次数
+        lastSimulationResult.iterations = steps;
+        lastSimulationResult.changedPins = ApplySequentialSnapshot(sequentialSnapshot);
+        return true;
+    }
 
-            // 通过坐标查找对应的引脚
-            Pin* startPin = FindPinByPosition(startX, startY);
-            Pin* endPin = FindPinByPosition(endX, endY);
+    // 取走后台保存的结果并报告；没有进行中的保存时停止轮询
+    void OnSaveTimer(wxTimerEvent& event) {
+        bool busy = saveThread.IsBusy();  // 先判断：不忙时所有结果都已经可以取走
+        if (!busy) saveTimer.Stop();
+        ReportSaveResults();
+    }
 
-            // 验证引脚类型匹配
-            if (startPin && endPin &&
-                startPin->IsInput() == (startIsInput == 1) &&
-                endPin->IsInput() == (endIsInput == 1)) {
+    // 自上次保存以来有编辑时在后台保存一份
+    void OnAutosaveTimer(wxTimerEvent& event) {
+        if (autosaveFilename.empty() || GetEditMarker() == autosaveMarker) return;
+        SubmitSave(autosaveFilename, true);
+    }
 
-                // 确保连接方向正确：输出引脚 -> 输入引脚
-                if (!startPin->IsInput() && endPin->IsInput()) {
-                    wires.push_back(std::make_unique<Wire>(startPin, endPin));
-                }
-                else if (startPin->IsInput() && !endPin->IsInput()) {
-                    wires.push_back(std::make_unique<Wire>(endPin, startPin));
-                }
+    // 把输入值交给后台线程，取走最新快照并重绘；电路结构变化后以画布当前状态重新启动线程
+    void OnSimulationTimer(wxTimerEvent& event) {
+        if (!backgroundSimulation.IsRunning()) return;
+        if (backgroundRestart) {
+            backgroundRestart = false;
+            SimulationThread::Mode mode = backgroundSimulation.GetMode();
+            backgroundSimulation.Stop();
+            TakeFinalBackgroundSnapshot();
+            if (!HasSequentialElements() || !PrepareSequential()) {
+                simulationTimer.Stop();
+                return;
             }
+            backgroundSimulation.Start(sequentialCircuit, mode);
         }
-    }
 
-    // 通过坐标查找引脚
-    Pin* FindPinByPosition(int x, int y) {
-        const int tolerance = 5;  // 容差范围
-        for (auto& element : elements) {
-            for (auto pin : element->GetPins()) {
-                int pinX = pin->GetX();
-                int pinY = pin->GetY();
-                if (abs(pinX - x) <= tolerance && abs(pinY - y) <= tolerance) {
-                    return pin;
-                }
+        size_t input = 0;
+        for (CircuitElement* element : sequentialBinding.elements) {
+            if (element->GetType() == TYPE_INPUT) {
+                backgroundSimulation.SetInput(input++, static_cast<InputOutput*>(element)->GetValue());
             }
         }
-        return nullptr;
+        if (backgroundSimulation.TakeSnapshot(sequentialSnapshot)) {
+            ApplySequentialSnapshot(sequentialSnapshot);
+            Refresh();
+        }
     }
 
     // 更新撤销/重做按钮状态
@@ -1625,6 +2264,48 @@ private:
     std::vector<std::unique_ptr<CircuitElement>> elements;  // 元件列表
     std::vector<std::unique_ptr<Wire>> wires;               // 导线列表
     Wire* selectedWire;           // 当前选中的导线
+    NetGraph netGraph;                      // 线网连接图（随导线增删增量维护）
+    EventDrivenSimulator simulator;         // 事件驱动仿真内核
+    SimulationResult lastSimulationResult;  // 最近一次仿真结果
+    SimulationMode simulationMode;          // 当前仿真模式
+    CompiledCircuit compiledCircuit;        // 编译后的指令流
+    NetlistBinding compiledBinding;         // 网表到画布引脚的映射
+    std::vector<InputOutput*> compiledInputs;   // 与输入槽位对应的输入元件
+    std::vector<InputOutput*> compiledOutputs;  // 与输出槽位对应的输出元件
+    std::vector<uint8_t> compiledValues;    // 线网值数组（0x00/0xFF）
+    bool compiledDirty;                     // 是否需要重新编译
+    bool compiledValuesValid;               // compiledValues 是否为当前输入下的求值结果（可增量更新）
+    IncrementalEvaluator incrementalEvaluator;  // 只沿输入变化的扇出锥求值
+    std::vector<uint32_t> slotPinOffsets;   // 槽位 -> slotPins 中的区间（CSR）
+    std::vector<Pin*> slotPins;             // 按槽位分组的写回引脚
+    std::vector<uint32_t> changedSlots;     // 增量求值中值改变的槽位（复用缓冲）
+    std::vector<CircuitElement*> watchedOutputs;  // 被观察的输出元件（空表示全部）
+    CompiledCircuit compiledCone;           // 被观察输出的扇入锥（未设置时无效）
+    std::vector<std::pair<Pin*, int>> conePins;   // 扇入锥中需要写回的引脚
+    std::vector<InputOutput*> coneOutputs;  // 与扇入锥输出槽位对应的输出元件
+    ParallelEvaluator parallelEvaluator;    // 按层并行求值（线程池按需创建）
+    bool parallelEvaluation;                // 是否启用按层并行求值
+    SequentialCircuit sequentialCircuit;    // 周期仿真（时序电路）
+    NetlistBinding sequentialBinding;       // 周期仿真网表到画布的映射
+    bool sequentialDirty;                   // 是否需要重新编译周期仿真
+    SequentialSnapshot sequentialSnapshot;  // 写回画布用的快照缓冲
+    SimulationThread backgroundSimulation;  // 后台仿真线程
+    wxTimer simulationTimer;                // 定期取走后台线程的快照
+    bool backgroundRestart;                 // 电路已修改，后台线程需要重新启动
+    uint64_t structuralHash;                // 最近一次计算的结构哈希
+    bool structuralHashDirty;               // 逻辑已修改，结构哈希需要重新计算
+    AnalysisCache<TruthTableData> truthTableCache;  // 按结构哈希缓存的真值表
+    AnalysisCache<CircuitBdd> bddCache;             // 按结构哈希缓存的输出 BDD
+    CircuitTextReader::Stats lastLoadStats;         // 最近一次加载电路文件的字节数和耗时
+    std::vector<CircuitElement*> elementById;       // 稳定 ID -> 元件（已删除的为空，ID 0 不使用）
+    SaveThread saveThread;                          // 后台保存线程
+    wxTimer saveTimer;                              // 有保存在进行时定期取走结果
+    wxTimer autosaveTimer;                          // 自动保存周期
+    wxString autosaveFilename;                      // 自动保存的目标文件，为空时不自动保存
+    uint64_t autosaveMarker;                        // 上次成功保存时的 GetEditMarker()
+
+    // 画布自己的定时器，事件按 ID 分发
+    enum { ID_SIMULATION_TIMER = wxID_HIGHEST + 900, ID_SAVE_TIMER, ID_AUTOSAVE_TIMER };
 
     // 绘制事件处理
     void OnPaint(wxPaintEvent& event) {
@@ -1934,7 +2615,8 @@ private:
                     // 切换输入值（0变1，1变0）
                     inputElement->SetValue(!inputElement->GetValue());
 
-                    // 更新电路状态
+                    // 只从这个输入沿扇出重新传播
+                    for (auto pin : inputElement->GetPins()) simulator.MarkDirty(pin);
                     UpdateCircuit();
 
                     // 更新状态栏
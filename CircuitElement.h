@@ -2,15 +2,16 @@
 #ifndef CIRCUITELEMENT_H
 #define CIRCUITELEMENT_H
 
+#include <cstdint>
 #include <wx/propgrid/propgrid.h> // 属性网格
-#include "Enums.h"
+#include "core/Enums.h"
 
 // 电路元素基类
 class CircuitElement {
 public:
     // 构造函数：初始化类型和位置
     CircuitElement(ElementType type, int x, int y)
-        : type(type), posX(x), posY(y), selected(false) {
+        : type(type), posX(x), posY(y), selected(false), id(0) {
     }
 
     virtual ~CircuitElement() {}  // 虚析构函数
@@ -22,6 +23,10 @@ public:
     bool IsSelected() const { return selected; }
     void SetSelected(bool sel) { selected = sel; }
 
+    // 画布分配的稳定 ID（0 表示尚未加入画布），撤销记录、剪贴板和导线引用按 ID 和引脚下标查找元件
+    uint32_t GetId() const { return id; }
+    void SetId(uint32_t newId) { id = newId; }
+
     // 设置位置并更新所有引脚位置
     void SetPosition(int x, int y) {
         int dx = x - posX;
@@ -52,10 +57,15 @@ public:
     virtual void GetProperties(wxPropertyGrid* pg) const = 0; // 获取属性
     virtual void SetProperties(wxPropertyGrid* pg) = 0;       // 设置属性
 
+    // 时序元件的内部状态位（布局见 core/SequentialCircuit.h），组合元件没有状态
+    virtual uint32_t GetStateBits() const { return 0; }
+    virtual void SetStateBits(uint32_t bits) {}
+
 protected:
     ElementType type;    // 元件类型
     int posX, posY;      // 位置坐标
     bool selected;       // 是否被选中
+    uint32_t id;         // 稳定 ID
 };
 
 #endif
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef ELEMENTFACTORY_H
+#define ELEMENTFACTORY_H
+
+#include <memory>
+#include "CircuitElement.h"
+#include "Gate.h"
+#include "InputOutput.h"
+#include "Sequence.h"
+
+// 元件工厂：按 ElementType 下标查编译期常量表得到构造函数和反序列化函数，
+// 新建、粘贴、撤销和加载文件都经过这里，新增元件类型只需在表中加一项
+namespace ElementFactory {
+
+    typedef std::unique_ptr<CircuitElement>(*Constructor)(ElementType type, int x, int y);
+    typedef void (*Deserializer)(CircuitElement* element, const wxString& data);
+
+    // construct 为空表示该类型不是可放置的元件；deserialize 为空表示构造后不需要再读附加字段
+    struct Entry {
+        Constructor construct;
+        Deserializer deserialize;
+    };
+
+    template <typename T>
+    inline std::unique_ptr<CircuitElement> Construct(ElementType, int x, int y) {
+        return std::make_unique<T>(x, y);
+    }
+
+    template <>
+    inline std::unique_ptr<CircuitElement> Construct<Gate>(ElementType type, int x, int y) {
+        return std::make_unique<Gate>(type, x, y);
+    }
+
+    template <>
+    inline std::unique_ptr<CircuitElement> Construct<InputOutput>(ElementType type, int x, int y) {
+        return std::make_unique<InputOutput>(type, x, y);
+    }
+
+    inline void DeserializeFields(CircuitElement* element, const wxString& data) {
+        element->Deserialize(data);
+    }
+
+    // 下标即 ElementType；门只有类型和坐标，构造函数已经建好引脚，不再反序列化
+    constexpr Entry TABLE[] = {
+        { &Construct<InputOutput>, &DeserializeFields },      // TYPE_INPUT
+        { &Construct<InputOutput>, &DeserializeFields },      // TYPE_OUTPUT
+        { &Construct<Gate>, nullptr },                        // TYPE_AND
+        { &Construct<Gate>, nullptr },                        // TYPE_OR
+        { &Construct<Gate>, nullptr },                        // TYPE_NOT
+        { &Construct<Gate>, nullptr },                        // TYPE_XOR
+        { &Construct<Gate>, nullptr },                        // TYPE_NAND
+        { &Construct<Gate>, nullptr },                        // TYPE_NOR
+        { nullptr, nullptr },                                 // TYPE_WIRE
+        { nullptr, nullptr },                                 // TYPE_SELECT
+        { nullptr, nullptr },                                 // TYPE_TOGGLE_VALUE
+        { &Construct<ClockElement>, &DeserializeFields },     // TYPE_CLOCK
+        { &Construct<RSFlipFlop>, &DeserializeFields },       // TYPE_RS_FLIPFLOP
+        { &Construct<DFlipFlop>, &DeserializeFields },        // TYPE_D_FLIPFLOP
+        { &Construct<JKFlipFlop>, &DeserializeFields },       // TYPE_JK_FLIPFLOP
+        { &Construct<TFlipFlop>, &DeserializeFields },        // TYPE_T_FLIPFLOP
+        { &Construct<RegisterElement>, &DeserializeFields },  // TYPE_REGISTER
+    };
+
+    static_assert(sizeof(TABLE) / sizeof(TABLE[0]) == TYPE_REGISTER + 1, "ElementFactory::TABLE must cover every element type");
+
+    constexpr const Entry* Find(int type) {
+        return type >= 0 && type <= TYPE_REGISTER && TABLE[type].construct ? &TABLE[type] : nullptr;
+    }
+
+    static_assert(Find(TYPE_WIRE) == nullptr && Find(TYPE_REGISTER) != nullptr, "ElementFactory::TABLE is out of order");
+
+    constexpr bool IsCreatable(int type) { return Find(type) != nullptr; }
+
+    // 在 (x, y) 新建默认状态的元件；类型不可放置时返回空
+    inline std::unique_ptr<CircuitElement> Create(ElementType type, int x, int y) {
+        const Entry* entry = Find(type);
+        return entry ? entry->construct(type, x, y) : nullptr;
+    }
+
+    // 按已解析出的类型和坐标新建元件，再由 data（完整的序列化行）恢复附加字段。
+    // 只有有附加字段的类型才会用到 data，调用方可以先用 NeedsData 判断是否需要准备它
+    inline std::unique_ptr<CircuitElement> Create(ElementType type, int x, int y, const wxString& data) {
+        const Entry* entry = Find(type);
+        if (!entry) return nullptr;
+        std::unique_ptr<CircuitElement> element = entry->construct(type, x, y);
+        if (entry->deserialize) entry->deserialize(element.get(), data);
+        return element;
+    }
+
+    inline bool NeedsData(int type) {
+        const Entry* entry = Find(type);
+        return entry && entry->deserialize;
+    }
+
+    // 按序列化行（类型,x,y,附加字段...）新建元件；格式错误或类型不可放置时返回空
+    inline std::unique_ptr<CircuitElement> CreateFromData(const wxString& data) {
+        wxStringTokenizer tokens(data, ",");
+        if (tokens.CountTokens() < 3) return nullptr;
+        long typeVal, x = 0, y = 0;
+        if (!tokens.GetNextToken().ToLong(&typeVal)) return nullptr;
+        tokens.GetNextToken().ToLong(&x);
+        tokens.GetNextToken().ToLong(&y);
+        return Create(static_cast<ElementType>(typeVal), static_cast<int>(x), static_cast<int>(y), data);
+    }
+}
+
+#endif
@@ -2,7 +2,9 @@
 #ifndef MAIN_H
 #define MAIN_H
               
+#include <cmath>
 #include <wx/splitter.h>      // 分割窗口      
+#include <wx/numdlg.h>        // 数值输入对话框
 #include "Pin.h"
 #include "CircuitCanvas.h"
 #include "Gate.h"
@@ -133,6 +135,7 @@ private:
             if (ConfirmSave()) {
                 canvas->Clear();  // 清空画布
                 currentFilename = "";  // 重置文件名
+                UpdateAutosave();
                 SetTitle("Logisim-like Circuit Simulator - New Circuit");  // 更新标题
                 GetStatusBar()->SetStatusText("New circuit created");  // 更新状态栏
                 propertiesPanel->UpdateProperties();  // 更新属性面板
@@ -143,16 +146,19 @@ private:
         case wxID_OPEN: {
             if (ConfirmSave()) {
                 wxFileDialog openFileDialog(this, "Open Circuit File", "", "",
-                    "Circuit files (*.circ)|*.circ", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+                    "Circuit files (*.circ;*.circb)|*.circ;*.circb", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
 
                 if (openFileDialog.ShowModal() == wxID_CANCEL)
                     return;
 
                 currentFilename = openFileDialog.GetPath();  // 获取文件路径
                 if (canvas->LoadCircuit(currentFilename)) {
+                    UpdateAutosave();
                     wxFileName fn(currentFilename);
                     SetTitle(wxString::Format("Logisim-like Circuit Simulator - %s", fn.GetFullName()));  // 更新标题
-                    GetStatusBar()->SetStatusText("Circuit loaded successfully");  // 更新状态栏
+                    const auto& stats = canvas->GetLastLoadStats();
+                    GetStatusBar()->SetStatusText(wxString::Format("Circuit loaded successfully (%.1f MB, %.1f MB/s)",
+                        stats.bytes / 1e6, stats.GetMegabytesPerSecond()));  // 更新状态栏
                     propertiesPanel->UpdateProperties();  // 更新属性面板
                 }
                 else {
@@ -168,12 +174,9 @@ private:
                 OnSaveAs(event);  // 如果无文件名，调用另存为
             }
             else {
-                if (canvas->SaveCircuit(currentFilename)) {
-                    GetStatusBar()->SetStatusText("Circuit saved successfully");
-                }
-                else {
-                    wxMessageBox("Failed to save circuit file", "Error", wxOK | wxICON_ERROR, this);
-                }
+                // 后台写文件，完成后画布在状态栏报告结果
+                canvas->SaveCircuitInBackground(currentFilename);
+                GetStatusBar()->SetStatusText("Saving circuit...");
             }
             break;
 
@@ -182,6 +185,25 @@ private:
             OnSaveAs(event);
             break;
 
+            // 自动保存开关
+        case MainMenu::ID_AUTOSAVE:
+            UpdateAutosave();
+            if (!menuBar->IsChecked(MainMenu::ID_AUTOSAVE)) {
+                GetStatusBar()->SetStatusText("Autosave disabled");
+            }
+            else if (currentFilename.empty()) {
+                GetStatusBar()->SetStatusText("Autosave starts after the circuit is saved");
+            }
+            else {
+                GetStatusBar()->SetStatusText(wxString::Format("Autosave enabled (every %d s)", CircuitCanvas::AUTOSAVE_INTERVAL_SECONDS));
+            }
+            break;
+
+            // 导出 C++ 仿真模型
+        case MainMenu::ID_EXPORT_MODEL:
+            OnExportModel();
+            break;
+
             // 退出程序
         case wxID_EXIT:
             Close(true);
@@ -191,6 +213,7 @@ private:
         case MainMenu::ID_START_SIM:
             canvas->StartSimulation();
             GetStatusBar()->SetStatusText("Simulation running");
+            ApplyBackgroundMode();
             break;
 
             // 停止仿真
@@ -200,10 +223,58 @@ private:
             break;
 
             // 单步仿真
-        case MainMenu::ID_STEP:
-            canvas->UpdateCircuit();
+        case MainMenu::ID_STEP: {
+            SimulationResult result = canvas->Step();
             canvas->Refresh();
-            GetStatusBar()->SetStatusText("Simulation step executed");
+            GetStatusBar()->SetStatusText(FormatSimulationResult(result));
+            break;
+        }
+
+            // 暂停/继续后台时钟，切换实时与尽快模式
+        case MainMenu::ID_PAUSE_SIM:
+        case MainMenu::ID_FAST_SIM:
+            ApplyBackgroundMode();
+            break;
+
+            // 设置仿真迭代上限
+        case MainMenu::ID_ITERATION_LIMIT: {
+            long limit = wxGetNumberFromUser("Maximum simulation iterations before a circuit is reported\n"
+                "as oscillating (0 = automatic: number of elements + 1, with an event budget).", "Limit:", "Iteration Limit",
+                static_cast<long>(canvas->GetIterationLimit()), 0, 1000000, this);
+            if (limit >= 0) {
+                canvas->SetIterationLimit(static_cast<size_t>(limit));
+                GetStatusBar()->SetStatusText(FormatSimulationResult(canvas->UpdateCircuit()));
+                canvas->Refresh();
+            }
+            break;
+        }
+
+            // 切换编译仿真模式
+        case MainMenu::ID_COMPILED_MODE: {
+            canvas->SetSimulationMode(event.IsChecked() ? SIM_COMPILED : SIM_EVENT_DRIVEN);
+            wxString reason;
+            if (!event.IsChecked()) {
+                GetStatusBar()->SetStatusText("Event-driven simulation mode");
+            }
+            else if (canvas->IsCompiledModeActive(&reason)) {
+                GetStatusBar()->SetStatusText("Compiled simulation mode");
+            }
+            else {
+                GetStatusBar()->SetStatusText("Compiled mode unavailable (" + reason + "), using event-driven simulation");
+            }
+            break;
+        }
+
+        case MainMenu::ID_PARALLEL_EVAL:
+            canvas->SetParallelEvaluation(event.IsChecked());
+            if (event.IsChecked()) {
+                GetStatusBar()->SetStatusText(wxString::Format("Parallel evaluation: %u worker threads%s",
+                    canvas->GetParallelWorkerCount(),
+                    canvas->GetSimulationMode() == SIM_COMPILED ? "" : " (takes effect in compiled mode)"));
+            }
+            else {
+                GetStatusBar()->SetStatusText("Parallel evaluation off");
+            }
             break;
 
             // 放大
@@ -390,6 +461,21 @@ private:
             GetStatusBar()->SetStatusText("Truth table displayed");
             break;
 
+            // 用 BDD 分析每个输出（不枚举真值表）
+        case MainMenu::ID_ANALYZE_OUTPUTS:
+            ShowOutputAnalysis();
+            break;
+
+            // 只仿真选中输出的扇入锥
+        case MainMenu::ID_WATCH_OUTPUTS:
+            WatchSelectedOutputs();
+            break;
+
+            // 与电路文件做等价性检查（SAT）
+        case MainMenu::ID_CHECK_EQUIVALENCE:
+            ShowEquivalenceCheck();
+            break;
+
             // 关于对话框
         case wxID_ABOUT:
             wxMessageBox("Logisim-like Circuit Simulator\n\n"
@@ -549,6 +635,7 @@ private:
         case MainToolbar::ID_START_SIM:
             canvas->StartSimulation();
             GetStatusBar()->SetStatusText("Simulation running");
+            ApplyBackgroundMode();
             break;
 
         case MainToolbar::ID_STOP_SIM:
@@ -556,11 +643,12 @@ private:
             GetStatusBar()->SetStatusText("Simulation stopped");
             break;
 
-        case MainToolbar::ID_STEP:
-            canvas->UpdateCircuit();
+        case MainToolbar::ID_STEP: {
+            SimulationResult result = canvas->Step();
             canvas->Refresh();
-            GetStatusBar()->SetStatusText("Simulation step executed");
+            GetStatusBar()->SetStatusText(FormatSimulationResult(result));
             break;
+        }
 
         case MainToolbar::ID_DELETE_ALL:
             canvas->DeleteAll();
@@ -638,6 +726,45 @@ private:
 
 
 
+    // 按菜单的勾选状态设置后台仿真线程的运行模式
+    void ApplyBackgroundMode() {
+        wxMenuBar* menuBar = GetMenuBar();
+        SimulationThread::Mode mode = SimulationThread::MODE_REALTIME;
+        if (menuBar->IsChecked(MainMenu::ID_PAUSE_SIM)) mode = SimulationThread::MODE_PAUSED;
+        else if (menuBar->IsChecked(MainMenu::ID_FAST_SIM)) mode = SimulationThread::MODE_FAST;
+        canvas->SetBackgroundSimulationMode(mode);
+
+        if (!canvas->IsBackgroundSimulationRunning()) return;
+        if (mode == SimulationThread::MODE_PAUSED) {
+            GetStatusBar()->SetStatusText("Simulation running (clock paused)");
+        }
+        else {
+            GetStatusBar()->SetStatusText(mode == SimulationThread::MODE_FAST ?
+                "Simulation running (clock as fast as possible)" : "Simulation running (real-time clock)");
+        }
+    }
+
+    // 仿真结果的状态栏文字；不收敛时列出仍在翻转的元件
+    wxString FormatSimulationResult(const SimulationResult& result) const {
+        wxString text = wxString::Format("Simulation step executed: %zu events, %zu iterations, %zu pin changes",
+            result.eventsProcessed, result.iterations, result.changedPins);
+        if (result.oscillating) {
+            const size_t maxListed = 5;
+            text << " | Oscillating: ";
+            for (size_t i = 0; i < result.oscillatingElements.size() && i < maxListed; ++i) {
+                if (i > 0) text << ", ";
+                text << result.oscillatingElements[i]->GetDisplayName();
+            }
+            if (result.oscillatingElements.size() > maxListed) {
+                text << wxString::Format(" and %zu more", result.oscillatingElements.size() - maxListed);
+            }
+        }
+        else if (result.budgetExhausted) {
+            text << " | Event budget exhausted before the circuit settled (set an iteration limit to run longer)";
+        }
+        return text;
+    }
+
     // 切换元件树显示状态
     void ToggleElementTree() {
         treeVisible = !treeVisible;  // 切换可见性标志
@@ -659,36 +786,152 @@ private:
     // 另存为处理函数
     void OnSaveAs(wxCommandEvent& event) {
         wxFileDialog saveFileDialog(this, "Save Circuit File", "", "",
-            "Circuit files (*.circ)|*.circ", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+            "Circuit files (*.circ)|*.circ|Binary circuit files (*.circb)|*.circb", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
 
         if (saveFileDialog.ShowModal() == wxID_CANCEL)
             return;
 
         currentFilename = saveFileDialog.GetPath();  // 获取文件路径
         if (!currentFilename.Contains(".")) {
-            currentFilename += ".circ";  // 添加文件扩展名
+            // 按选择的文件类型添加扩展名（二进制格式加载更快，适合大电路）
+            currentFilename += saveFileDialog.GetFilterIndex() == 1 ? BinaryCircuitFile::GetExtension() : ".circ";
         }
 
-        if (canvas->SaveCircuit(currentFilename)) {
-            wxFileName fn(currentFilename);
-            SetTitle(wxString::Format("Logisim-like Circuit Simulator - %s", fn.GetFullName()));  // 更新标题
-            GetStatusBar()->SetStatusText("Circuit saved successfully");  // 更新状态栏
+        canvas->SaveCircuitInBackground(currentFilename);
+        UpdateAutosave();
+        wxFileName fn(currentFilename);
+        SetTitle(wxString::Format("Logisim-like Circuit Simulator - %s", fn.GetFullName()));  // 更新标题
+        GetStatusBar()->SetStatusText("Saving circuit...");  // 结果由画布在保存完成后报告
+    }
+
+    // 自动保存写到当前文件旁边的恢复文件（如 adder.autosave.circ），不覆盖用户保存的文件；新电路保存之前不自动保存
+    void UpdateAutosave() {
+        if (!menuBar->IsChecked(MainMenu::ID_AUTOSAVE) || currentFilename.empty()) {
+            canvas->SetAutosave("");
+            return;
+        }
+        wxFileName fn(currentFilename);
+        fn.SetName(fn.GetName() + ".autosave");
+        canvas->SetAutosave(fn.GetFullPath());
+    }
+
+    // 显示每个输出的符号分析结果：是否为常量、满足赋值的比例和一个满足赋值
+    void ShowOutputAnalysis() {
+        wxString error;
+        std::shared_ptr<const CircuitBdd> bdd = canvas->GetOutputBdds(&error);
+        if (!bdd) {
+            wxMessageBox("Cannot analyze the circuit: " + error, "Analyze Outputs", wxOK | wxICON_ERROR, this);
+            return;
+        }
+
+        const BddManager& manager = bdd->GetManager();
+        wxString report;
+        for (size_t o = 0; o < bdd->GetOutputCount(); ++o) {
+            BddNode f = bdd->GetOutput(o);
+            if (BddManager::IsConstant(f)) {
+                report += wxString::Format("Output %zu: constant %d\n", o + 1, f == BddManager::ONE ? 1 : 0);
+                continue;
+            }
+            double fraction = std::ldexp(manager.SatCount(f), -manager.GetVariableCount());
+            report += wxString::Format("Output %zu: 1 for %.4g%% of inputs, %zu BDD nodes\n    e.g.",
+                o + 1, fraction * 100, manager.GetNodeCount(f));
+            std::vector<int> witness;
+            manager.AnySat(f, witness);
+            for (size_t i = 0; i < witness.size(); ++i) {
+                if (witness[i] >= 0) report += wxString::Format(" Input %zu=%d", i + 1, witness[i]);
+            }
+            report += "\n";
+        }
+        if (report.empty()) report = "No outputs";
+        wxMessageBox(report, "Analyze Outputs", wxOK | wxICON_INFORMATION, this);
+        GetStatusBar()->SetStatusText(wxString::Format("Analyzed %zu outputs over %d inputs",
+            bdd->GetOutputCount(), manager.GetVariableCount()));
+    }
+
+    // 把选中的输出设为被观察的输出；没有选中输出时恢复仿真全部元件
+    void WatchSelectedOutputs() {
+        canvas->SetWatchedOutputs(canvas->GetSelectedOutputs());
+        size_t coneSize, totalSize;
+        canvas->GetConeStatistics(coneSize, totalSize);
+        if (canvas->GetWatchedOutputs().empty()) {
+            GetStatusBar()->SetStatusText("Simulating all outputs");
         }
         else {
-            wxMessageBox("Failed to save circuit file", "Error", wxOK | wxICON_ERROR, this);
+            GetStatusBar()->SetStatusText(wxString::Format("Watching %zu outputs: simulating %zu of %zu",
+                canvas->GetWatchedOutputs().size(), coneSize, totalSize));
         }
     }
 
-    // 确认保存（简化实现）
+    // 选择一个电路文件，检查它与当前电路是否等价；不等价时给出反例
+    void ShowEquivalenceCheck() {
+        wxFileDialog openFileDialog(this, "Compare With Circuit File", "", "",
+            "Circuit files (*.circ;*.circb)|*.circ;*.circb", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+        if (openFileDialog.ShowModal() == wxID_CANCEL)
+            return;
+
+        EquivalenceChecker checker;
+        wxString error;
+        bool checked;
+        {
+            wxBusyCursor busy;
+            checked = canvas->CheckEquivalence(openFileDialog.GetPath(), checker, &error);
+        }
+        if (!checked) {
+            wxMessageBox("Cannot check equivalence: " + error, "Check Equivalence", wxOK | wxICON_ERROR, this);
+            return;
+        }
+
+        wxString report;
+        if (checker.IsEquivalent()) {
+            report = "The circuits are equivalent.";
+        }
+        else {
+            report = "The circuits differ.\n\nCounterexample:";
+            const std::vector<bool>& inputs = checker.GetCounterexample();
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                report += wxString::Format(" Input %zu=%d", i + 1, inputs[i] ? 1 : 0);
+            }
+            report += "\nDiffering outputs:";
+            for (int o : checker.GetDifferingOutputs()) report += wxString::Format(" Output %d", o + 1);
+        }
+        wxMessageBox(report, "Check Equivalence", wxOK | wxICON_INFORMATION, this);
+        GetStatusBar()->SetStatusText(wxString::Format("Equivalence check: %llu conflicts",
+            static_cast<unsigned long long>(checker.GetSolver().GetConflictCount())));
+    }
+
+    // 导出 C++ 仿真模型：所选文件名决定类名，源文件写到同一目录
+    void OnExportModel() {
+        wxFileDialog exportDialog(this, "Export C++ Model", "", "CircuitModel.h",
+            "C++ header (*.h)|*.h", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+        if (exportDialog.ShowModal() == wxID_CANCEL)
+            return;
+
+        wxFileName fn(exportDialog.GetPath());
+        wxString error;
+        if (canvas->ExportModel(fn.GetPath(), fn.GetName(), &error)) {
+            GetStatusBar()->SetStatusText(wxString::Format("Model exported to %s", fn.GetPath()));
+        }
+        else {
+            wxMessageBox("Failed to export model: " + error, "Error", wxOK | wxICON_ERROR, this);
+        }
+    }
+
+    // 确认保存（简化实现）：先等后台保存写完，上次保存失败时询问是否放弃当前电路
     bool ConfirmSave() {
         // 在实际应用中，这里应该检查电路是否已修改
-        return true;
+        if (canvas->FinishSaving()) return true;
+        return wxMessageBox("The circuit could not be saved. Discard it anyway?", "Confirm",
+            wxYES_NO | wxICON_WARNING, this) == wxYES;
     }
 
     // 关闭窗口事件处理
     void OnClose(wxCloseEvent& event) {
-
-        if (wxMessageBox("Are you sure you want to exit?", "Confirm Exit",
+        // 等后台保存写完再退出，保存失败时提醒修改尚未保存
+        wxString question = canvas->FinishSaving() ? "Are you sure you want to exit?" :
+            "The circuit could not be saved. Exit anyway?";
+        if (wxMessageBox(question, "Confirm Exit",
             wxYES_NO | wxICON_QUESTION, this) == wxYES) {
             Destroy();  // 销毁窗口
         }
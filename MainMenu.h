@@ -11,6 +11,8 @@ public:
         fileMenu->Append(wxID_OPEN, "&Open\tCtrl+O", "Open a circuit file");
         fileMenu->Append(wxID_SAVE, "&Save\tCtrl+S", "Save the circuit");
         fileMenu->Append(wxID_SAVEAS, "Save &As...", "Save the circuit with a new name");
+        fileMenu->AppendCheckItem(ID_AUTOSAVE, "Auto&save", "Periodically save a recovery copy next to the circuit file");
+        fileMenu->Append(ID_EXPORT_MODEL, "Export C++ &Model...", "Export the circuit as a standalone C++ simulation model");
         fileMenu->AppendSeparator();
         fileMenu->Append(wxID_EXIT, "E&xit\tAlt+F4", "Exit the application");
 
@@ -33,11 +35,19 @@ public:
         wxMenu* simMenu = new wxMenu();
         simMenu->Append(ID_START_SIM, "&Start Simulation\tF5", "Start circuit simulation");
         simMenu->Append(ID_STOP_SIM, "S&top Simulation\tF6", "Stop circuit simulation");
+        simMenu->AppendCheckItem(ID_PAUSE_SIM, "&Pause\tF8", "Pause the background clock");
+        simMenu->AppendCheckItem(ID_FAST_SIM, "Run As &Fast As Possible", "Advance clocks as fast as possible instead of in real time");
         simMenu->AppendSeparator();
         simMenu->Append(ID_RESET, "&Reset", "Reset the simulation");
         simMenu->Append(ID_STEP, "&Step\tF7", "Single simulation step");
+        simMenu->AppendCheckItem(ID_COMPILED_MODE, "&Compiled Mode", "Evaluate combinational circuits with a levelized instruction stream");
+        simMenu->AppendCheckItem(ID_PARALLEL_EVAL, "&Parallel Evaluation", "Evaluate wide logic levels on all CPU cores (compiled mode)");
+        simMenu->Append(ID_ITERATION_LIMIT, "Iteration &Limit...", "Set how many iterations a circuit may take to settle");
+        simMenu->Append(ID_WATCH_OUTPUTS, "&Watch Selected Outputs", "Simulate only the fan-in cone of the selected outputs (no selection: all outputs)");
         simMenu->AppendSeparator();
         simMenu->Append(ID_TRUTH_TABLE, "&Truth Table\tT", "Show truth table");
+        simMenu->Append(ID_ANALYZE_OUTPUTS, "&Analyze Outputs...", "Analyze every output symbolically with binary decision diagrams");
+        simMenu->Append(ID_CHECK_EQUIVALENCE, "Check &Equivalence...", "Prove the circuit equivalent to a circuit file or find a counterexample");
 
         // 视图菜单
         wxMenu* viewMenu = new wxMenu();
@@ -125,8 +135,18 @@ public:
         ID_DELETE_ALL,
         ID_DELETE,
         ID_TRUTH_TABLE,
+        ID_COMPILED_MODE,
+        ID_PARALLEL_EVAL,
+        ID_ITERATION_LIMIT,
+        ID_PAUSE_SIM,
+        ID_FAST_SIM,
+        ID_EXPORT_MODEL,
+        ID_ANALYZE_OUTPUTS,
+        ID_CHECK_EQUIVALENCE,
+        ID_WATCH_OUTPUTS,
+        ID_AUTOSAVE,
         ID_CENTER_VIEW,
-        ID_FIT_TO_WINDOW
+        ID_FIT_TO_WINDOW   // 必须是最后一个：MainToolbar 的 ID 从它之后开始
     };
 
 private:
@@ -0,0 +1,176 @@
+#pragma once
+#ifndef NETGRAPH_H
+#define NETGRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 线网连接图：每个线网有一个驱动引脚（导线起点）和任意多个读取引脚（导线终点）。
+// 增删导线时增量维护；读取引脚按线网压缩成 CSR 数组，供仿真按扇出传播
+class NetGraph {
+public:
+    NetGraph() : netCount(0), compactDirty(false) {}
+
+    // 添加导线：加入起点所驱动的线网，没有则新建
+    void AddWire(Wire* wire) {
+        Pin* driver = wire->GetStartPin();
+        Pin* reader = wire->GetEndPin();
+        if (!driver || !reader) return;
+
+        // 从输入引脚引出的导线（导线到导线的连接点）单独成网，输入引脚自身的编号仍表示它读取的线网
+        int net = driver->IsInput() ? FindDrivenNet(driver) : driver->GetNet();
+        if (net < 0 || nets[net].driver != driver) {
+            net = AllocateNet(driver);
+            if (!driver->IsInput()) driver->SetNet(net);
+        }
+        nets[net].wires.push_back(wire);
+        wire->SetNet(net);
+        driver->AddConnection();
+        reader->AddConnection();
+        reader->SetNet(net);  // 一个读取引脚被多根导线驱动时以最后连接的为准
+        compactDirty = true;
+    }
+
+    // 移除导线（在导线对象销毁之前调用）
+    void RemoveWire(Wire* wire) {
+        int net = wire->GetNet();
+        if (net < 0) return;
+        auto& netWires = nets[net].wires;
+        auto it = std::find(netWires.begin(), netWires.end(), wire);
+        if (it == netWires.end()) return;
+        netWires.erase(it);
+        wire->SetNet(-1);
+
+        Pin* driver = wire->GetStartPin();
+        Pin* reader = wire->GetEndPin();
+        driver->RemoveConnection();
+        reader->RemoveConnection();
+
+        // 读取引脚可能仍被其他导线驱动
+        if (reader->GetNet() == net) {
+            reader->SetNet(reader->GetConnectionCount() > 0 ? FindDrivingNet(reader) : -1);
+        }
+        if (netWires.empty()) {
+            if (nets[net].driver->GetNet() == net) nets[net].driver->SetNet(-1);
+            FreeNet(net);
+        }
+        compactDirty = true;
+    }
+
+    void Clear() {
+        for (auto& net : nets) {
+            if (!net.driver) continue;
+            net.driver->ResetConnections();
+            for (Wire* wire : net.wires) {
+                wire->GetStartPin()->ResetConnections();
+                wire->GetEndPin()->ResetConnections();
+                wire->SetNet(-1);
+            }
+        }
+        nets.clear();
+        freeNets.clear();
+        netCount = 0;
+        readerOffsets.clear();
+        readerPins.clear();
+        compactDirty = false;
+    }
+
+    // 线网编号上界（含已释放的编号）
+    int GetNetCapacity() const { return static_cast<int>(nets.size()); }
+    // 实际使用中的线网数量
+    int GetNetCount() const { return netCount; }
+
+    // 线网的驱动引脚（已释放的线网返回 nullptr）
+    Pin* GetDriver(int net) const {
+        return (net >= 0 && net < static_cast<int>(nets.size())) ? nets[net].driver : nullptr;
+    }
+
+    // 驱动某个输入引脚的输出引脚
+    Pin* GetDriverOf(const Pin* reader) const {
+        Pin* driver = GetDriver(reader->GetNet());
+        return driver != reader ? driver : nullptr;
+    }
+
+    // 线网上的所有导线
+    const std::vector<Wire*>& GetWires(int net) const { return nets[net].wires; }
+
+    // 引脚作为驱动者时的读取引脚数
+    size_t GetFanout(const Pin* driver) const {
+        int net = driver->GetNet();
+        return (net >= 0 && nets[net].driver == driver) ? nets[net].wires.size() : 0;
+    }
+
+    // CSR 形式的读取引脚：线网 n 的读取者为 readerPins[readerOffsets[n] .. readerOffsets[n+1])
+    const std::vector<uint32_t>& GetReaderOffsets() const { Compact(); return readerOffsets; }
+    const std::vector<Pin*>& GetReaderPins() const { Compact(); return readerPins; }
+
+private:
+    struct NetRecord {
+        Pin* driver;               // 驱动引脚（nullptr 表示编号空闲）
+        std::vector<Wire*> wires;  // 从驱动引脚出发的导线
+    };
+
+    int AllocateNet(Pin* driver) {
+        int net;
+        if (!freeNets.empty()) {
+            net = freeNets.back();
+            freeNets.pop_back();
+        }
+        else {
+            net = static_cast<int>(nets.size());
+            nets.emplace_back();
+        }
+        nets[net].driver = driver;
+        nets[net].wires.clear();
+        netCount++;
+        return net;
+    }
+
+    void FreeNet(int net) {
+        nets[net].driver = nullptr;
+        nets[net].wires.clear();
+        freeNets.push_back(net);
+        netCount--;
+    }
+
+    // 查找由某个输入引脚驱动的线网（仅导线到导线的连接点需要）
+    int FindDrivenNet(const Pin* driver) const {
+        for (size_t n = 0; n < nets.size(); ++n) {
+            if (nets[n].driver == driver) return static_cast<int>(n);
+        }
+        return -1;
+    }
+
+    // 查找仍在驱动该读取引脚的线网（仅在多驱动冲突时才需要）
+    int FindDrivingNet(const Pin* reader) const {
+        int found = -1;
+        for (size_t n = 0; n < nets.size(); ++n) {
+            for (Wire* wire : nets[n].wires) {
+                if (wire->GetEndPin() == reader) found = static_cast<int>(n);
+            }
+        }
+        return found;
+    }
+
+    // 按需重建 CSR 数组
+    void Compact() const {
+        if (!compactDirty) return;
+        compactDirty = false;
+        readerOffsets.assign(nets.size() + 1, 0);
+        readerPins.clear();
+        for (size_t n = 0; n < nets.size(); ++n) {
+            for (Wire* wire : nets[n].wires) readerPins.push_back(wire->GetEndPin());
+            readerOffsets[n + 1] = static_cast<uint32_t>(readerPins.size());
+        }
+    }
+
+    std::vector<NetRecord> nets;                  // 按编号索引的线网
+    std::vector<int> freeNets;                    // 可复用的线网编号
+    int netCount;                                 // 使用中的线网数量
+    mutable std::vector<uint32_t> readerOffsets;  // CSR 偏移
+    mutable std::vector<Pin*> readerPins;         // CSR 读取引脚
+    mutable bool compactDirty;                    // CSR 是否需要重建
+};
+
+#endif
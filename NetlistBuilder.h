@@ -0,0 +1,92 @@
+#pragma once
+#ifndef NETLISTBUILDER_H
+#define NETLISTBUILDER_H
+
+#include <unordered_map>
+#include "core/Netlist.h"
+
+// 网表与画布对象之间的对应关系，用于把仿真结果写回引脚
+struct NetlistBinding {
+    std::vector<CircuitElement*> elements;          // 网表元件下标 -> 画布元件
+    std::vector<std::pair<Pin*, int>> pins;         // 每个非虚拟引脚及其所在线网
+};
+
+// 从画布的元件和导线构建扁平网表
+class NetlistBuilder {
+public:
+    static void Build(const std::vector<std::unique_ptr<CircuitElement>>& elements,
+        const std::vector<std::unique_ptr<Wire>>& wires,
+        Netlist& netlist, NetlistBinding* binding = nullptr) {
+        netlist.Clear();
+        if (binding) {
+            binding->elements.clear();
+            binding->pins.clear();
+        }
+
+        // 第一遍：为每个输出引脚分配线网
+        std::unordered_map<Pin*, int> outputNet;
+        std::vector<std::vector<Pin*>> elementPins;
+        elementPins.reserve(elements.size());
+        for (auto& element : elements) {
+            bool value = false;
+            if (element->GetType() == TYPE_INPUT) {
+                if (InputOutput* io = dynamic_cast<InputOutput*>(element.get())) {
+                    value = io->GetValue();
+                }
+            }
+            int index = netlist.AddElement(element->GetType(), value, element->GetX(), element->GetY());
+            if (element->GetType() == TYPE_INPUT || element->GetType() == TYPE_OUTPUT ||
+                (element->GetType() >= TYPE_CLOCK && element->GetType() <= TYPE_REGISTER)) {
+                netlist.GetElements()[index].attributes = SerializedAttributes(element.get());
+            }
+            elementPins.push_back(element->GetPins());
+            for (Pin* pin : elementPins.back()) {
+                if (pin->IsInput()) continue;
+                int net = netlist.AddNet();
+                outputNet[pin] = net;
+                netlist.GetElements()[index].outputs.push_back(net);
+            }
+            if (binding) binding->elements.push_back(element.get());
+        }
+
+        // 第二遍：输入引脚读取驱动它的导线起点所在线网（多根导线时以最后一根为准）
+        std::unordered_map<Pin*, int> inputNet;
+        for (auto& wire : wires) {
+            Pin* start = wire->GetStartPin();
+            Pin* end = wire->GetEndPin();
+            if (!start || !end) continue;
+            auto it = outputNet.find(start);
+            if (it != outputNet.end()) inputNet[end] = it->second;
+        }
+
+        for (size_t i = 0; i < elements.size(); ++i) {
+            NetlistElement& element = netlist.GetElements()[i];
+            for (Pin* pin : elementPins[i]) {
+                if (pin->IsInput()) {
+                    auto it = inputNet.find(pin);
+                    int net = (it != inputNet.end()) ? it->second : Netlist::CONST_ZERO_NET;
+                    element.inputs.push_back(net);
+                    if (binding) binding->pins.emplace_back(pin, net);
+                }
+                else if (binding) {
+                    binding->pins.emplace_back(pin, outputNet[pin]);
+                }
+            }
+        }
+    }
+
+    // 元件序列化结果中坐标之后的字段（输入输出的值和名称、时序元件的初始状态和时钟参数），与文件中的格式相同（UTF-8）
+    static std::string SerializedAttributes(const CircuitElement* element) {
+        wxString data;
+        element->Serialize(data);
+        std::string text(data.utf8_str());
+        size_t rest = 0;
+        for (int n = 0; n < 3 && rest != std::string::npos; ++n) {
+            rest = text.find(',', rest);
+            if (rest != std::string::npos) ++rest;
+        }
+        return rest != std::string::npos ? text.substr(rest) : std::string();
+    }
+};
+
+#endif
@@ -12,7 +12,7 @@ public:
     // 构造函数：初始化引脚位置、类型和父元素
     Pin(int x, int y, bool isInput, CircuitElement* parent, bool isVirtual = false)
         : posX(x), posY(y), input(isInput), value(false),
-        connectedWire(nullptr), parentElement(parent), virtualPin(isVirtual) {
+        net(-1), connectionCount(0), parentElement(parent), virtualPin(isVirtual) {
     }
 
     // Getter方法 - 获取引脚属性
@@ -24,11 +24,18 @@ public:
 
     // Setter方法 - 设置引脚属性  
     void SetValue(bool val) { value = val; }
-    void SetConnectedWire(Wire* wire) { connectedWire = wire; }
     void SetPosition(int x, int y) { posX = x; posY = y; }
 
-    // 获取连接的导线
-    Wire* GetConnectedWire() const { return connectedWire; }
+    // 所在线网（由 NetGraph 维护，-1 表示未连接）
+    int GetNet() const { return net; }
+    void SetNet(int id) { net = id; }
+
+    // 连接到该引脚的导线数
+    int GetConnectionCount() const { return connectionCount; }
+    bool IsConnected() const { return connectionCount > 0; }
+    void AddConnection() { connectionCount++; }
+    void RemoveConnection() { if (connectionCount > 0) connectionCount--; }
+    void ResetConnections() { connectionCount = 0; net = -1; }
 
     // 获取父元素
     CircuitElement* GetParent() const { return parentElement; }
@@ -42,7 +49,8 @@ private:
     int posX, posY;           // 引脚坐标
     bool input;               // 是否为输入引脚
     bool value;               // 逻辑值(true=1, false=0)
-    Wire* connectedWire;      // 连接的导线
+    int net;                  // 所在线网编号
+    int connectionCount;      // 连接的导线数
     CircuitElement* parentElement; // 所属的电路元件
     bool virtualPin;          // 新增：是否为虚拟引脚
 };
@@ -88,6 +88,7 @@ private:
         CircuitElement* selected = canvas->GetSelectedElement();
         if (selected) {
             selected->SetProperties(pg);
+            canvas->OnElementPropertiesChanged();
             canvas->Refresh();
             UpdateConnectionInfo(); // 属性改变后更新连接信息
         }
@@ -179,10 +180,8 @@ private:
         else {
             for (size_t i = 0; i < inputPins.size(); ++i) {
                 Pin* pin = inputPins[i];
-                Wire* connectedWire = pin->GetConnectedWire();
-                if (connectedWire) {
-                    Pin* sourcePin = (connectedWire->GetStartPin() == pin) ?
-                        connectedWire->GetEndPin() : connectedWire->GetStartPin();
+                Pin* sourcePin = canvas->GetNetGraph().GetDriverOf(pin);
+                if (sourcePin) {
                     info << wxString::Format("  %zu. %s ← %s\n",
                         i + 1, GetPinShortInfo(pin).c_str(), GetPinElementInfo(sourcePin).c_str());
                 }
@@ -200,12 +199,13 @@ private:
         else {
             for (size_t i = 0; i < outputPins.size(); ++i) {
                 Pin* pin = outputPins[i];
-                Wire* connectedWire = pin->GetConnectedWire();
-                if (connectedWire) {
-                    Pin* targetPin = (connectedWire->GetStartPin() == pin) ?
-                        connectedWire->GetEndPin() : connectedWire->GetStartPin();
-                    info << wxString::Format("  %zu. %s → %s\n",
-                        i + 1, GetPinShortInfo(pin).c_str(), GetPinElementInfo(targetPin).c_str());
+                const NetGraph& graph = canvas->GetNetGraph();
+                if (graph.GetFanout(pin) > 0) {
+                    // 输出引脚的每个读取者各占一行
+                    for (Wire* wire : graph.GetWires(pin->GetNet())) {
+                        info << wxString::Format("  %zu. %s → %s\n",
+                            i + 1, GetPinShortInfo(pin).c_str(), GetPinElementInfo(wire->GetEndPin()).c_str());
+                    }
                 }
                 else {
                     info << wxString::Format("  %zu. %s : NOT CONNECTED\n",
@@ -262,7 +262,7 @@ private:
 
         // 统计连接数
         for (auto pin : pins) {
-            if (pin->GetConnectedWire()) {
+            if (pin->IsConnected()) {
                 if (pin->IsInput()) {
                     inputConnections++;
                 }
@@ -118,6 +118,17 @@ public:
         }
     }
 
+    // 状态位：bit0 为输出值，其余位为分频计数器
+    virtual uint32_t GetStateBits() const override {
+        return (value ? 1u : 0u) | (static_cast<uint32_t>(counter) << 1);
+    }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        value = (bits & 1u) != 0;
+        counter = static_cast<int>(bits >> 1);
+        if (!pins.empty()) pins[0]->SetValue(value);
+    }
+
     void SetFrequency(int freq) { frequency = freq; }
     int GetFrequency() const { return frequency; }
     void SetEnabled(bool en) { enabled = en; }
@@ -268,6 +279,16 @@ public:
         }
     }
 
+    // 状态位：bit0 = Q，bit1 = Q'
+    virtual uint32_t GetStateBits() const override { return (q ? 1u : 0u) | (qNot ? 2u : 0u); }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        q = (bits & 1u) != 0;
+        qNot = (bits & 2u) != 0;
+        pins[2]->SetValue(q);
+        pins[3]->SetValue(qNot);
+    }
+
 private:
     std::vector<std::unique_ptr<Pin>> pins;
     bool q;
@@ -393,6 +414,15 @@ public:
         }
     }
 
+    // 状态位：bit0 = Q
+    virtual uint32_t GetStateBits() const override { return q ? 1u : 0u; }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        q = (bits & 1u) != 0;
+        pins[2]->SetValue(q);
+        pins[3]->SetValue(!q);
+    }
+
 private:
     std::vector<std::unique_ptr<Pin>> pins;
     bool q;
@@ -530,6 +560,15 @@ public:
         }
     }
 
+    // 状态位：bit0 = Q
+    virtual uint32_t GetStateBits() const override { return q ? 1u : 0u; }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        q = (bits & 1u) != 0;
+        pins[3]->SetValue(q);
+        pins[4]->SetValue(!q);
+    }
+
 private:
     std::vector<std::unique_ptr<Pin>> pins;
     bool q;
@@ -658,6 +697,15 @@ public:
         }
     }
 
+    // 状态位：bit0 = Q
+    virtual uint32_t GetStateBits() const override { return q ? 1u : 0u; }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        q = (bits & 1u) != 0;
+        pins[2]->SetValue(q);
+        pins[3]->SetValue(!q);
+    }
+
 private:
     std::vector<std::unique_ptr<Pin>> pins;
     bool q;
@@ -806,6 +854,22 @@ public:
         }
     }
 
+    // 状态位：bit0..bit3 = Q0..Q3
+    virtual uint32_t GetStateBits() const override {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            if (data[i]) bits |= 1u << i;
+        }
+        return bits;
+    }
+
+    virtual void SetStateBits(uint32_t bits) override {
+        for (int i = 0; i < 4; i++) {
+            data[i] = ((bits >> i) & 1u) != 0;
+            pins[6 + i]->SetValue(data[i]);
+        }
+    }
+
 private:
     std::vector<std::unique_ptr<Pin>> pins;
     bool data[4];
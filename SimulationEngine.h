@@ -0,0 +1,338 @@
+#pragma once
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "NetGraph.h"
+
+// 仿真模式
+enum SimulationMode {
+    SIM_EVENT_DRIVEN,  // 事件驱动（支持任意电路）
+    SIM_COMPILED       // 分层编译（仅无环组合电路，否则回退到事件驱动）
+};
+
+// 一次仿真的统计结果
+struct SimulationResult {
+    size_t eventsProcessed = 0;  // 处理的事件数（元件求值次数）
+    size_t iterations = 0;       // 迭代轮数：每轮求值上一轮中输入发生变化的元件
+    size_t changedPins = 0;      // 引脚值变化的次数
+    bool converged = true;       // 是否在上限内达到不动点（没有引脚再变化）
+    bool oscillating = false;    // 达到迭代上限时仍有元件在翻转（例如奇数个反相器组成的环）
+    bool budgetExhausted = false; // 自动上限下事件数用完，电路未必振荡（例如很深的电路中毛刺反复传播）
+    std::vector<CircuitElement*> oscillatingElements;  // 达到上限时仍待求值的元件
+};
+
+// 事件驱动仿真内核：引脚值变化时只调度其扇出上的元件，逐轮迭代直到没有引脚再变化（不动点）
+class EventDrivenSimulator {
+public:
+    // 未设置迭代上限时，每个元件最多被求值的平均次数，超过则放弃本次求值
+    static const size_t MAX_EVENTS_PER_ELEMENT = 64;
+
+    EventDrivenSimulator() : changedPins(0), iterationLimit(0), coneSize(0), topologyDirty(true), fullPassPending(true) {}
+
+    // 电路整体被替换（加载、清空、切换模式等）时调用：下次运行前重建扇出表并重新求值所有元件
+    void Invalidate() {
+        topologyDirty = true;
+        fullPassPending = true;
+        dirtyPins.clear();
+    }
+
+    // 局部增删元件或导线后调用：重建扇出表，但只从受影响的引脚重新传播。
+    // 输入引脚从其线网的驱动者重新取值，输出引脚的元件无条件向扇出传播。
+    // 设置了扇入锥时，编辑可能把此前未求值的元件带入锥中，仍求值所有元件
+    void InvalidateLocal(const std::vector<Pin*>& pins) {
+        if (!coneRoots.empty()) {
+            Invalidate();
+            return;
+        }
+        topologyDirty = true;
+        if (!fullPassPending) dirtyPins.insert(dirtyPins.end(), pins.begin(), pins.end());
+    }
+
+    // 引脚所属元件的值被直接修改（例如切换输入），下次运行从这里开始传播。
+    // 没有任何标记时运行会保守地从所有输入元件出发
+    void MarkDirty(Pin* pin) {
+        if (!fullPassPending) dirtyPins.push_back(pin);
+    }
+
+    // 引脚即将随元件或导线一起被删除，丢弃指向它们的标记
+    void Forget(const std::vector<Pin*>& pins) {
+        dirtyPins.erase(std::remove_if(dirtyPins.begin(), dirtyPins.end(), [&pins](Pin* pin) {
+            return std::find(pins.begin(), pins.end(), pin) != pins.end();
+        }), dirtyPins.end());
+    }
+
+    // 这次求值没有经过内核（例如编译模式已算出全部引脚值）：丢弃累积的传播起点，避免无限增长
+    void DiscardDirty() { dirtyPins.clear(); }
+
+    // 迭代轮数上限；0 表示自动（元件数 + 1，足以让任意深度的无环电路稳定）
+    void SetIterationLimit(size_t limit) { iterationLimit = limit; }
+    size_t GetIterationLimit() const { return iterationLimit; }
+
+    // 只求值这些输出元件的扇入锥（空表示全部元件）；扇入锥随扇出表一起在下次运行前重建，
+    // 新进入扇入锥的元件此前没有求值，下次运行求值所有元件
+    void SetCone(const std::vector<CircuitElement*>& outputs) {
+        coneRoots = outputs;
+        Invalidate();
+    }
+
+    // 扇入锥中的元件数和参与求值的元件总数（最近一次重建时）
+    size_t GetConeSize() const { return coneSize; }
+    size_t GetNodeCount() const { return nodes.size(); }
+
+    // 运行仿真直到稳定
+    SimulationResult Run(const std::vector<std::unique_ptr<CircuitElement>>& elements,
+        const NetGraph& graph) {
+        bool fullPass = fullPassPending;
+        if (topologyDirty) {
+            Rebuild(elements, graph);
+            topologyDirty = false;
+        }
+        fullPassPending = false;
+        changedPins = 0;
+
+        // 电路被整体替换后所有元件都需重新求值；有标记时只从标记的引脚出发；
+        // 否则从所有输入元件出发（扇入锥以外的元件不调度）
+        if (!fullPass && !dirtyPins.empty()) {
+            ScheduleDirty();
+        }
+        else {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (fullPass || nodes[i].element->GetType() == TYPE_INPUT) {
+                    Schedule(static_cast<int>(i), fullPass);
+                }
+            }
+        }
+        dirtyPins.clear();
+
+        // 不由内核求值的驱动者（时序元件等）的输出值也要传到读取者
+        for (int net : externalNets) {
+            Propagate(net, driverPins[net]->GetValue(), fullPass);
+        }
+
+        SimulationResult result;
+        // 调用者设置的迭代上限优先，此时不再另加事件数上限
+        const size_t maxEvents = iterationLimit ? SIZE_MAX : MAX_EVENTS_PER_ELEMENT * (nodes.size() + 1);
+        const size_t maxIterations = iterationLimit ? iterationLimit : nodes.size() + 1;
+        while (!pending.empty()) {
+            if (result.iterations >= maxIterations) {
+                result.converged = false;
+                result.oscillating = true;
+                for (int index : pending) result.oscillatingElements.push_back(nodes[index].element);
+                break;
+            }
+            if (result.eventsProcessed >= maxEvents) {
+                result.converged = false;
+                result.budgetExhausted = true;
+                break;
+            }
+
+            // 本轮求值上一轮调度的元件，新产生的事件进入下一轮
+            current.swap(pending);
+            pending.clear();
+            result.iterations++;
+            for (int index : current) {
+                Node& node = nodes[index];
+                node.queued = false;
+                bool force = node.force;
+                node.force = false;
+
+                // 记录求值前的输出值，用于检测变化
+                for (size_t k = 0; k < node.outputs.size(); ++k) {
+                    oldValues[k] = node.outputs[k]->GetValue();
+                }
+
+                node.element->Update();
+                result.eventsProcessed++;
+
+                // 只有发生变化的输出引脚才向扇出传播
+                for (size_t k = 0; k < node.outputs.size(); ++k) {
+                    Pin* out = node.outputs[k];
+                    bool value = out->GetValue();
+                    if (value != oldValues[k]) changedPins++;
+                    if (node.outputNets[k] < 0 || (!force && value == oldValues[k])) continue;
+                    Propagate(node.outputNets[k], value, force);
+                }
+            }
+        }
+        result.changedPins = changedPins;
+
+        // 未处理完的事件丢弃，下次运行重新开始
+        for (int index : pending) {
+            nodes[index].queued = false;
+            nodes[index].force = false;
+        }
+        pending.clear();
+        return result;
+    }
+
+private:
+    // 扇出项：被驱动的输入引脚及其所属元件的节点编号（-1 表示不参与求值）
+    struct Reader {
+        Pin* pin;
+        int node;
+    };
+
+    // 参与求值的元件节点
+    struct Node {
+        CircuitElement* element;
+        std::vector<Pin*> outputs;  // 缓存的输出引脚，避免每次调用 GetPins()
+        std::vector<int> outputNets;  // 各输出引脚驱动的线网（-1 表示无扇出）
+        bool queued;
+        bool force;                 // 是否无条件向扇出传播
+        bool inCone;                // 是否在被观察输出的扇入锥中
+    };
+
+    // 是否由仿真内核求值（与原 UpdateCircuit 的范围一致）
+    static bool IsEvaluated(ElementType type) {
+        return type == TYPE_INPUT || type == TYPE_OUTPUT ||
+            (type >= TYPE_AND && type <= TYPE_NOR);
+    }
+
+    // 重建节点表，并把线网图的读取引脚映射到节点
+    void Rebuild(const std::vector<std::unique_ptr<CircuitElement>>& elements, const NetGraph& graph) {
+        nodes.clear();
+        externalNets.clear();
+        pending.clear();
+        nodeIndex.clear();
+        nodeIndex.reserve(elements.size());
+        nodes.reserve(elements.size());
+        size_t maxOutputs = 0;
+        for (auto& element : elements) {
+            if (!IsEvaluated(element->GetType())) continue;
+            Node node{ element.get(), {}, {}, false, false, true };
+            for (auto pin : element->GetPins()) {
+                if (pin->IsInput()) continue;
+                node.outputs.push_back(pin);
+                node.outputNets.push_back(graph.GetFanout(pin) > 0 ? pin->GetNet() : -1);
+            }
+            maxOutputs = std::max(maxOutputs, node.outputs.size());
+            nodeIndex[element.get()] = static_cast<int>(nodes.size());
+            nodes.push_back(std::move(node));
+        }
+        oldValues.assign(maxOutputs, false);
+
+        // 复制线网图的 CSR 数组，并为每个读取引脚记录其节点编号
+        readerOffsets = graph.GetReaderOffsets();
+        const auto& pins = graph.GetReaderPins();
+        readers.resize(pins.size());
+        for (size_t i = 0; i < pins.size(); ++i) {
+            auto it = nodeIndex.find(pins[i]->GetParent());
+            readers[i] = Reader{ pins[i], it != nodeIndex.end() ? it->second : -1 };
+        }
+
+        driverPins.assign(graph.GetNetCapacity(), nullptr);
+        for (int net = 0; net < graph.GetNetCapacity(); ++net) {
+            Pin* driver = graph.GetDriver(net);
+            driverPins[net] = driver;
+            if (driver && nodeIndex.find(driver->GetParent()) == nodeIndex.end()) {
+                externalNets.push_back(net);
+            }
+        }
+        MarkCone(nodeIndex, graph);
+    }
+
+    // 从被观察的输出元件出发沿线网图反向遍历，标记扇入锥中的节点
+    void MarkCone(const std::unordered_map<CircuitElement*, int>& nodeIndex, const NetGraph& graph) {
+        coneSize = nodes.size();
+        if (coneRoots.empty()) return;
+
+        for (Node& node : nodes) node.inCone = false;
+        coneSize = 0;
+        std::vector<int> stack;
+        auto mark = [&](CircuitElement* element) {
+            auto it = nodeIndex.find(element);
+            if (it == nodeIndex.end() || nodes[it->second].inCone) return;
+            nodes[it->second].inCone = true;
+            coneSize++;
+            stack.push_back(it->second);
+        };
+        for (CircuitElement* root : coneRoots) mark(root);
+
+        // 驱动者为输入引脚时（导线到导线的连接点）继续追溯它读取的线网
+        std::unordered_set<Pin*> junctions;
+        std::vector<Pin*> readersToResolve;
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            for (Pin* pin : nodes[index].element->GetPins()) {
+                if (pin->IsInput()) readersToResolve.push_back(pin);
+            }
+            while (!readersToResolve.empty()) {
+                Pin* reader = readersToResolve.back();
+                readersToResolve.pop_back();
+                Pin* driver = graph.GetDriverOf(reader);
+                if (!driver) continue;
+                if (driver->IsInput()) {
+                    if (junctions.insert(driver).second) readersToResolve.push_back(driver);
+                }
+                else if (driver->GetParent()) {
+                    mark(driver->GetParent());
+                }
+            }
+        }
+    }
+
+    // 调度被标记的引脚所属的元件；输入引脚先从驱动者取得新值（读取的线网可能已改变）
+    void ScheduleDirty() {
+        for (Pin* pin : dirtyPins) {
+            if (pin->IsInput()) {
+                int net = pin->GetNet();
+                if (net >= 0 && net < static_cast<int>(driverPins.size()) && driverPins[net]) {
+                    bool value = driverPins[net]->GetValue();
+                    if (pin->GetValue() != value) changedPins++;
+                    pin->SetValue(value);
+                }
+            }
+            auto it = nodeIndex.find(pin->GetParent());
+            if (it != nodeIndex.end()) Schedule(it->second, !pin->IsInput());
+        }
+    }
+
+    // 将元件加入下一轮的事件队列
+    void Schedule(int index, bool force) {
+        Node& node = nodes[index];
+        if (!node.inCone) return;
+        node.force = node.force || force;
+        if (!node.queued) {
+            node.queued = true;
+            pending.push_back(index);
+        }
+    }
+
+    // 把线网的值传到所有读取者，并调度值发生变化的读取元件
+    void Propagate(int net, bool value, bool force) {
+        for (uint32_t i = readerOffsets[net]; i < readerOffsets[net + 1]; ++i) {
+            const Reader& reader = readers[i];
+            bool changed = reader.pin->GetValue() != value;
+            reader.pin->SetValue(value);
+            if (changed) changedPins++;
+            if (reader.node >= 0 && (changed || force)) {
+                Schedule(reader.node, false);
+            }
+        }
+    }
+
+    std::vector<Node> nodes;                                  // 参与求值的元件
+    std::unordered_map<CircuitElement*, int> nodeIndex;       // 元件 -> 节点编号
+    std::vector<uint32_t> readerOffsets;                      // 线网 -> readers 中的区间（CSR）
+    std::vector<Reader> readers;                              // 所有线网的读取者
+    std::vector<Pin*> driverPins;                             // 线网 -> 驱动引脚
+    std::vector<int> externalNets;                            // 驱动者不参与求值的线网
+    std::vector<int> current;                                 // 本轮求值的元件
+    std::vector<int> pending;                                 // 下一轮待求值的元件
+    std::vector<bool> oldValues;                              // 求值前的输出值（复用缓冲）
+    size_t changedPins;                                       // 本次运行中引脚值变化的次数
+    size_t iterationLimit;                                    // 迭代轮数上限（0 为自动）
+    std::vector<CircuitElement*> coneRoots;                   // 被观察的输出元件（空表示全部）
+    size_t coneSize;                                          // 扇入锥中的节点数
+    bool topologyDirty;                                       // 扇出表是否需要重建
+    bool fullPassPending;                                     // 下次运行是否求值所有元件
+    std::vector<Pin*> dirtyPins;                              // 下次运行的传播起点
+};
+
+#endif
@@ -4,7 +4,13 @@
 
 #include <wx/wx.h>         
 #include <wx/grid.h>               // 网格控件     
+#include <wx/progdlg.h>            // 进度对话框
 #include "CircuitCanvas.h"
+#include "TruthTableGridTable.h"
+#include "core/CircuitFile.h"
+#include "core/LogicMinimizer.h"
+#include "core/ParallelTruthTable.h"
+#include "core/StructuralHash.h"
 
 // 真值表对话框
 class TruthTableDialog : public wxDialog {
@@ -22,6 +28,8 @@ public:
         wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
         buttonSizer->Add(new wxButton(this, wxID_CLOSE, "Close"), 0, wxALL, 5);
         buttonSizer->Add(new wxButton(this, wxID_REFRESH, "Refresh"), 0, wxALL, 5);
+        wxButton* minimizeButton = new wxButton(this, wxID_ANY, "Minimize...");
+        buttonSizer->Add(minimizeButton, 0, wxALL, 5);
 
         mainSizer->Add(buttonSizer, 0, wxALIGN_CENTER | wxALL, 5);
 
@@ -30,6 +38,7 @@ public:
         // 绑定事件
         Bind(wxEVT_BUTTON, &TruthTableDialog::OnClose, this, wxID_CLOSE);
         Bind(wxEVT_BUTTON, &TruthTableDialog::OnRefresh, this, wxID_REFRESH);
+        Bind(wxEVT_BUTTON, &TruthTableDialog::OnMinimize, this, minimizeButton->GetId());
 
         GenerateTruthTable();
     }
@@ -39,66 +48,164 @@ public:
         std::vector<InputOutput*> inputs = canvas->GetInputPins();
         std::vector<InputOutput*> outputs = canvas->GetOutputPins();
 
-        int numInputs = static_cast<int>(inputs.size());
-        int numOutputs = static_cast<int>(outputs.size());
-
-        // 清除现有网格
-        if (grid->GetNumberRows() > 0) {
-            grid->DeleteRows(0, grid->GetNumberRows());
-        }
-        if (grid->GetNumberCols() > 0) {
-            grid->DeleteCols(0, grid->GetNumberCols());
+        // 组合电路编译后在多个线程上用位并行求值，否则逐行驱动画布仿真。
+        // 编译得到的结果按结构哈希缓存，电路逻辑没有变化（包括只移动了元件）时直接复用。
+        // 设置了被观察的输出时只对它们的扇入锥求值，表中只有这些输出列
+        std::shared_ptr<const TruthTableData> data;
+        bool combinational = false;
+        std::vector<int> watched = canvas->GetWatchedOutputIndices();
+        wxString placeholder = "No inputs/outputs";
+        if (inputs.size() > static_cast<size_t>(TruthTableData::MAX_INPUTS)) {
+            // 每个输出需要 2^n 位，输入太多时分配会失败
+            placeholder = wxString::Format("Too many inputs for a truth table (%zu)", inputs.size());
+            wxMessageBox(wxString::Format("The circuit has %zu inputs; a truth table supports at most %d.\n"
+                "Use Simulation > Analyze Outputs to analyze the outputs symbolically instead.",
+                inputs.size(), TruthTableData::MAX_INPUTS), "Truth Table", wxOK | wxICON_INFORMATION, this);
         }
-
-        if (numInputs == 0 && numOutputs == 0) {
-            // 没有 IO，显示提示
-            grid->CreateGrid(1, 1);
-            grid->SetCellValue(0, 0, "No inputs/outputs");
-            grid->AutoSize();
-            return;
+        else if (!inputs.empty() || !outputs.empty()) {
+            uint64_t key = canvas->GetStructuralHash();
+            for (int o : watched) key = StructuralHash::Mix(key, static_cast<uint64_t>(o));
+            data = canvas->GetTruthTableCache().Find(key);
+            combinational = data != nullptr;
+            if (!data) {
+                Netlist netlist;
+                NetlistBuilder::Build(canvas->GetElements(), canvas->GetWires(), netlist);
+                CompiledCircuit compiled, cone;
+                auto table = std::make_shared<TruthTableData>();
+                if (!compiled.Compile(netlist)) {
+                    // 含环路时结果取决于当前状态，不缓存
+                    GenerateBySimulation(inputs, outputs, *table);
+                    data = table;
+                    watched.clear();
+                }
+                else if (GenerateParallel(SelectOutputs(compiled, watched, cone), *table)) {
+                    data = table;
+                    combinational = true;
+                    canvas->GetTruthTableCache().Store(key, data);
+                }
+                else {
+                    placeholder = "Truth table generation cancelled";
+                }
+            }
         }
 
-        int rows = (numInputs > 0) ? (1 << numInputs) : 1;
-        int cols = numInputs + numOutputs;
-        if (cols == 0) cols = 1; // 防御
+        minimizable = combinational && watched.empty() ? data : nullptr;
 
-        grid->CreateGrid(rows, cols);
+        // 网格只向数据源请求可见行的单元格，打开时不再逐格填表
+        TruthTableGridTable* gridTable = new TruthTableGridTable(data, placeholder, watched);
+        grid->SetTable(gridTable, true);
+        grid->EnableEditing(false);
+        grid->SetDefaultCellAlignment(wxALIGN_CENTER, wxALIGN_CENTER);
 
-        // 设置列标签
-        for (int i = 0; i < numInputs; ++i) {
-            grid->SetColLabelValue(i, wxString::Format("Input %d", i + 1));
+        // 按表头和最长的行号设置列宽，不用 AutoSize（它会遍历所有行）
+        if (gridTable->IsPlaceholder()) {
+            grid->AutoSizeColumns();
         }
-        for (int i = 0; i < numOutputs; ++i) {
-            grid->SetColLabelValue(numInputs + i, wxString::Format("Output %d", i + 1));
+        else {
+            for (int col = 0; col < gridTable->GetNumberCols(); ++col) {
+                grid->AutoSizeColLabelSize(col);
+            }
         }
+        wxString widestRow = gridTable->GetRowLabelValue(gridTable->GetNumberRows() - 1);
+        grid->SetRowLabelSize(grid->GetTextExtent(widestRow).GetWidth() + 16);
+        grid->ForceRefresh();
+    }
+
 
-        // 对每个输入组合，设置输入 -> 运行画布仿真 -> 读取输出填表
-        for (int row = 0; row < rows; ++row) {
-            // 设置输入值（高位到低位对应 Input1..InputN）
-            for (int i = 0; i < numInputs; ++i) {
-                bool bit = ((row >> (numInputs - i - 1)) & 1) != 0;
-                // 将值写入 InputOutput 的 value（它的 Update() 会把值写到 pin）
-                inputs[i]->SetValue(bit);
-                grid->SetCellValue(row, i, bit ? "1" : "0");
-                grid->SetCellAlignment(row, i, wxALIGN_CENTER, wxALIGN_CENTER);
+private:
+    // 在工作线程上生成真值表；超过片刻仍未完成时显示可取消的进度条。被取消时返回 false
+    bool GenerateParallel(const CompiledCircuit& compiled, TruthTableData& table) {
+        ParallelTruthTable generator;
+        generator.Start(compiled);
+        if (!generator.WaitFor(std::chrono::milliseconds(200))) {
+            wxProgressDialog progress("Truth Table", wxString::Format("Evaluating %llu rows...",
+                static_cast<unsigned long long>(generator.GetTable().rows)), 1000, this,
+                wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME);
+            while (!generator.WaitFor(std::chrono::milliseconds(50))) {
+                if (!progress.Update(static_cast<int>(generator.GetProgress() * 999))) {
+                    generator.Cancel();
+                }
             }
+        }
+        if (!generator.Wait()) return false;
+        std::swap(table, generator.GetTable());
+        return true;
+    }
 
-            // 让画布进行一次完整传播（会调用每个 element->Update() 与 wire->Update()）
+    // 只生成 outputs 中的输出时提取它们的扇入锥（写入 cone），否则使用整个电路
+    static const CompiledCircuit& SelectOutputs(const CompiledCircuit& compiled, const std::vector<int>& outputs,
+        CompiledCircuit& cone) {
+        if (outputs.empty()) return compiled;
+        compiled.ExtractCone(outputs, cone);
+        return cone;
+    }
+
+    // 逐行设置输入并运行画布仿真（用于含时序元件或环路、无法编译的电路）
+    void GenerateBySimulation(const std::vector<InputOutput*>& inputs,
+        const std::vector<InputOutput*>& outputs, TruthTableData& table) {
+        table.Resize(static_cast<int>(inputs.size()), static_cast<int>(outputs.size()));
+
+        for (uint64_t row = 0; row < table.rows; ++row) {
+            for (int i = 0; i < table.numInputs; ++i) {
+                inputs[i]->SetValue(table.GetInput(row, i));
+            }
             canvas->UpdateCircuit();
+            for (int j = 0; j < table.numOutputs; ++j) {
+                if (outputs[j]->GetValue()) {
+                    table.bits[j * table.wordsPerOutput + (row >> 6)] |= uint64_t(1) << (row & 63);
+                }
+            }
+        }
+    }
+
+    // 逐个输出最小化为与或表达式，显示结果并询问是否用两级门电路替换画布上的电路
+    void OnMinimize(wxCommandEvent& event) {
+        if (!minimizable) {
+            wxMessageBox("Minimization needs the truth table of all outputs of a combinational circuit.",
+                "Minimize", wxOK | wxICON_INFORMATION, this);
+            return;
+        }
+        if (minimizable->numInputs > LogicMinimizer::MAX_INPUTS) {
+            wxMessageBox(wxString::Format("Minimization supports at most %d inputs.", LogicMinimizer::MAX_INPUTS),
+                "Minimize", wxOK | wxICON_INFORMATION, this);
+            return;
+        }
 
-            // 读取输出引脚的值
-            for (int j = 0; j < numOutputs; ++j) {
-                bool outVal = outputs[j]->GetValue();
-                grid->SetCellValue(row, numInputs + j, outVal ? "1" : "0");
-                grid->SetCellAlignment(row, numInputs + j, wxALIGN_CENTER, wxALIGN_CENTER);
+        Netlist original, minimized;
+        std::vector<std::vector<Cube>> covers(minimizable->numOutputs);
+        {
+            wxBusyCursor busy;
+            for (int o = 0; o < minimizable->numOutputs; ++o) {
+                LogicMinimizer::Minimize(*minimizable, o, covers[o]);
             }
+            NetlistBuilder::Build(canvas->GetElements(), canvas->GetWires(), original);
+            LogicMinimizer::Synthesize(original, covers, minimized);
+        }
+
+        // 表达式过长时截断显示
+        const size_t maxLength = 200;
+        wxString report;
+        for (int o = 0; o < minimizable->numOutputs; ++o) {
+            std::string expression = LogicMinimizer::Format(covers[o], minimizable->numInputs);
+            if (expression.size() > maxLength) expression = expression.substr(0, maxLength) + " ...";
+            report += wxString::Format("Output %d = %s\n", o + 1, wxString::FromUTF8(expression.c_str()));
         }
+        report += wxString::Format("\nGates: %d before, %d after.\n\nReplace the circuit with the minimized version?",
+            CountGates(original), CountGates(minimized));
+        if (wxMessageBox(report, "Minimize", wxYES_NO | wxICON_QUESTION, this) != wxYES) return;
 
-        grid->AutoSize();
+        canvas->ReplaceCircuit(wxString::FromUTF8(CircuitFile::Format(minimized).c_str()));
+        GenerateTruthTable();
     }
 
+    static int CountGates(const Netlist& netlist) {
+        int gates = 0;
+        for (const NetlistElement& element : netlist.GetElements()) {
+            if (element.type >= TYPE_AND && element.type <= TYPE_NOR) gates++;
+        }
+        return gates;
+    }
 
-private:
     void OnClose(wxCommandEvent& event) {
         Close();
     }
@@ -109,6 +216,7 @@ private:
 
     wxGrid* grid;
     CircuitCanvas* canvas;
+    std::shared_ptr<const TruthTableData> minimizable;  // 可最小化的真值表（组合电路编译所得）
 };
 
 void CircuitCanvas::ShowTruthTable() {
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef TRUTHTABLEGRIDTABLE_H
+#define TRUTHTABLEGRIDTABLE_H
+
+#include <climits>
+#include <memory>
+#include <vector>
+#include <wx/grid.h>               // 网格控件
+#include "core/TruthTable.h"
+
+// 真值表的虚拟网格数据源：只保存打包的输出位（每行每个输出一位），
+// 网格绘制可见行时才按行号生成单元格文本，不为每个单元格分配 wxString
+class TruthTableGridTable : public wxGridTableBase {
+public:
+    // data 为空指针时整张表只显示 placeholder；表格数据可与真值表缓存共享。
+    // outputIndices 为各输出列在电路全部输出中的下标（只生成部分输出时用于列标题），空表示依次对应
+    explicit TruthTableGridTable(std::shared_ptr<const TruthTableData> data,
+        const wxString& placeholder = "No inputs/outputs", std::vector<int> outputIndices = {})
+        : data(std::move(data)), placeholder(placeholder), outputIndices(std::move(outputIndices)) {}
+
+    const TruthTableData* GetData() const { return data.get(); }
+
+    // 没有表格数据（没有输入输出或生成被取消）时显示一行提示
+    bool IsPlaceholder() const { return !data || data->rows == 0; }
+
+    int GetNumberRows() override {
+        if (IsPlaceholder()) return 1;
+        return data->rows > static_cast<uint64_t>(INT_MAX) ? INT_MAX : static_cast<int>(data->rows);
+    }
+
+    int GetNumberCols() override {
+        return IsPlaceholder() ? 1 : data->numInputs + data->numOutputs;
+    }
+
+    bool IsEmptyCell(int row, int col) override { return false; }
+
+    // 前 numInputs 列为输入（由行号得出），其后为输出（取打包位）
+    wxString GetValue(int row, int col) override {
+        if (IsPlaceholder()) return placeholder;
+        bool value = col < data->numInputs ? data->GetInput(row, col)
+            : data->GetOutput(row, col - data->numInputs);
+        return value ? "1" : "0";
+    }
+
+    // 真值表只读
+    void SetValue(int row, int col, const wxString& value) override {}
+
+    wxString GetColLabelValue(int col) override {
+        if (IsPlaceholder()) return "";
+        if (col < data->numInputs) return wxString::Format("Input %d", col + 1);
+        int output = col - data->numInputs;
+        if (output < static_cast<int>(outputIndices.size())) output = outputIndices[output];
+        return wxString::Format("Output %d", output + 1);
+    }
+
+    wxString GetRowLabelValue(int row) override {
+        return wxString::Format("%d", row + 1);
+    }
+
+private:
+    std::shared_ptr<const TruthTableData> data;
+    wxString placeholder;
+    std::vector<int> outputIndices;
+};
+
+#endif
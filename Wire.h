@@ -5,15 +5,8 @@
 class Wire {
 public:
     // 构造函数，接收起始引脚和结束引脚
-    Wire(Pin* start, Pin* end) : startPin(start), endPin(end) {
-        // 建立双向连接：将导线对象设置到两个引脚中
-        if (start && !start->IsVirtual()) {
-            start->SetConnectedWire(this);
-        }
-        if (end && !end->IsVirtual()) {
-            end->SetConnectedWire(this);
-        }
-    }
+    // 引脚与线网的连接关系由 NetGraph 维护
+    Wire(Pin* start, Pin* end) : startPin(start), endPin(end), net(-1) {}
 
     // 绘制导线
     void Draw(wxDC& dc) {
@@ -39,6 +32,10 @@ public:
     // 获取结束引脚
     Pin* GetEndPin() const { return endPin; }
 
+    // 所属线网（由 NetGraph 维护）
+    int GetNet() const { return net; }
+    void SetNet(int id) { net = id; }
+
     // 检查点是否在导线附近（用于选择导线）
     bool ContainsPoint(const wxPoint& point) const {
         if (!startPin || !endPin) return false;  // 如果引脚不存在返回false
@@ -99,6 +96,7 @@ public:
 private:
     Pin* startPin;  // 起始引脚指针
     Pin* endPin;    // 结束引脚指针
+    int net;        // 所属线网编号
 };
 
 #endif
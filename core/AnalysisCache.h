@@ -0,0 +1,62 @@
+#pragma once
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 以电路结构哈希为键的分析结果缓存（真值表等）。只保留最近使用的少量结果，
+// 电路改回先前的结构时仍能命中；结果以只读共享指针返回，调用者无需复制
+template <typename Result>
+class AnalysisCache {
+public:
+    enum : size_t { DEFAULT_CAPACITY = 4 };
+
+    explicit AnalysisCache(size_t capacity = DEFAULT_CAPACITY) : capacity(capacity > 0 ? capacity : 1), clock(0) {}
+
+    // 查找结构哈希为 key 的结果；没有时返回空指针
+    std::shared_ptr<const Result> Find(uint64_t key) {
+        for (Entry& entry : entries) {
+            if (entry.key != key) continue;
+            entry.lastUse = ++clock;
+            return entry.result;
+        }
+        return nullptr;
+    }
+
+    // 保存结果；已满时替换最久未使用的一项
+    void Store(uint64_t key, std::shared_ptr<const Result> result) {
+        for (Entry& entry : entries) {
+            if (entry.key != key) continue;
+            entry.result = std::move(result);
+            entry.lastUse = ++clock;
+            return;
+        }
+        if (entries.size() < capacity) {
+            entries.push_back(Entry{ key, std::move(result), ++clock });
+            return;
+        }
+        Entry* oldest = &entries[0];
+        for (Entry& entry : entries) {
+            if (entry.lastUse < oldest->lastUse) oldest = &entry;
+        }
+        *oldest = Entry{ key, std::move(result), ++clock };
+    }
+
+    void Clear() { entries.clear(); }
+    size_t GetSize() const { return entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::shared_ptr<const Result> result;
+        uint64_t lastUse;
+    };
+
+    size_t capacity;
+    uint64_t clock;              // 使用计数，用于淘汰最久未使用的结果
+    std::vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "AtomicFile.h"
+
+#include "FilePath.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+bool AtomicFileWriter::Open(const std::string& filename, std::string* error) {
+    Discard();
+    target = filename;
+    temporary = filename + GetTemporarySuffix();
+    failed = false;
+    written = 0;
+    file = FilePath::Open(temporary, "wb");
+    if (!file) return Fail(error, "cannot create " + temporary);
+    return true;
+}
+
+void AtomicFileWriter::Write(const void* data, size_t size) {
+    if (!file || failed || size == 0) return;
+    if (std::fwrite(data, 1, size, file) != size) {
+        failed = true;
+        return;
+    }
+    written += size;
+}
+
+bool AtomicFileWriter::Commit(std::string* error) {
+    if (!file) return Fail(error, "no file is open");
+    if (failed || std::fflush(file) != 0) return Fail(error, "write failed: " + temporary);
+    // 改名之前内容必须已经落盘，否则断电后目标文件可能是空的
+#ifdef _WIN32
+    bool synced = _commit(_fileno(file)) == 0;
+#else
+    bool synced = ::fsync(fileno(file)) == 0;
+#endif
+    if (!synced) return Fail(error, "cannot flush " + temporary);
+    bool closed = std::fclose(file) == 0;
+    file = nullptr;
+    if (!closed) return Fail(error, "write failed: " + temporary);
+
+#ifdef _WIN32
+    // rename 不能覆盖已有文件，MoveFileEx 可以替换目标
+    bool renamed = MoveFileExW(FilePath::ToWide(temporary).c_str(), FilePath::ToWide(target).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool renamed = std::rename(temporary.c_str(), target.c_str()) == 0;
+#endif
+    if (!renamed) return Fail(error, "cannot replace " + target);
+    temporary.clear();
+    return true;
+}
+
+void AtomicFileWriter::Discard() {
+    if (file) std::fclose(file);
+    file = nullptr;
+    if (!temporary.empty()) FilePath::Remove(temporary);
+    temporary.clear();
+}
+
+bool AtomicFileWriter::Fail(std::string* error, const std::string& message) {
+    Discard();
+    if (error) *error = message;
+    return false;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// 原子地替换文件：内容先写入目标旁边的临时文件，Commit 时刷到磁盘再改名为目标文件。
+// 写入失败或没有 Commit 就销毁时删除临时文件，目标文件保持原样，不会留下写了一半的文件
+class AtomicFileWriter {
+public:
+    AtomicFileWriter() : file(nullptr), failed(false), written(0) {}
+    ~AtomicFileWriter() { Discard(); }
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    bool Open(const std::string& filename, std::string* error = nullptr);
+
+    // 写入失败后忽略之后的写入，由 Commit 报告错误
+    void Write(const void* data, size_t size);
+    void Write(const std::string& data) { Write(data.data(), data.size()); }
+
+    // 刷到磁盘并改名为目标文件
+    bool Commit(std::string* error = nullptr);
+
+    // 放弃写入并删除临时文件
+    void Discard();
+
+    uint64_t GetBytesWritten() const { return written; }
+
+    static const char* GetTemporarySuffix() { return ".saving"; }
+
+private:
+    bool Fail(std::string* error, const std::string& message);
+
+    std::FILE* file;
+    std::string target;
+    std::string temporary;
+    bool failed;
+    uint64_t written;
+};
+
+#endif
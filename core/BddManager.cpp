@@ -0,0 +1,352 @@
+#include "BddManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+    // 重排时单个变量移动过程中允许的结点数增长上限
+    const double MAX_GROWTH = 1.2;
+
+    const size_t INITIAL_BUCKETS = 16;
+
+}
+
+BddManager::BddManager(int variableCount)
+    : freeList(NO_NODE), liveNodes(0), gcThreshold(DEFAULT_GC_THRESHOLD),
+    reorderThreshold(MIN_REORDER_THRESHOLD), autoReorder(true), collections(0), reorders(0) {
+    nodes.push_back(Node{ TERMINAL_VAR, ZERO, ZERO, NO_NODE, 0 });
+    nodes.push_back(Node{ TERMINAL_VAR, ONE, ONE, NO_NODE, 0 });
+    cache.assign(CACHE_SIZE, CacheEntry{ OP_NONE, 0, 0, 0 });
+    for (int i = 0; i < variableCount; ++i) AddVariable();
+}
+
+int BddManager::AddVariable() {
+    int var = GetVariableCount();
+    varToLevel.push_back(var);
+    levelToVar.push_back(var);
+    subtables.emplace_back();
+    subtables.back().buckets.assign(INITIAL_BUCKETS, NO_NODE);
+    return var;
+}
+
+bool BddManager::SetOrder(const std::vector<int>& order) {
+    if (liveNodes != 0 || order.size() != levelToVar.size()) return false;
+    std::vector<bool> seen(order.size(), false);
+    for (int var : order) {
+        if (var < 0 || var >= GetVariableCount() || seen[var]) return false;
+        seen[var] = true;
+    }
+    levelToVar = order;
+    for (size_t level = 0; level < order.size(); ++level) varToLevel[order[level]] = static_cast<int>(level);
+    return true;
+}
+
+BddNode BddManager::Variable(int var) {
+    return MakeNode(static_cast<uint32_t>(var), ZERO, ONE);
+}
+
+BddNode BddManager::Apply(Op op, BddNode f, BddNode g) {
+    // 终结情形
+    switch (op) {
+    case OP_AND:
+        if (f == ZERO || g == ZERO) return ZERO;
+        if (f == ONE) return g;
+        if (g == ONE || f == g) return f;
+        break;
+    case OP_OR:
+        if (f == ONE || g == ONE) return ONE;
+        if (f == ZERO) return g;
+        if (g == ZERO || f == g) return f;
+        break;
+    default:
+        if (f == g) return ZERO;
+        if (f == ZERO) return g;
+        if (g == ZERO) return f;
+        if (f <= ONE && g <= ONE) return f ^ g;
+        break;
+    }
+    if (f > g) std::swap(f, g);  // 三种运算都满足交换律
+
+    const size_t slot = Hash(f, g ^ (op << 30), CACHE_SIZE - 1);
+    if (cache[slot].op == op && cache[slot].f == f && cache[slot].g == g) return cache[slot].result;
+
+    // 按顶层变量展开
+    int levelF = Level(f), levelG = Level(g);
+    int top = std::min(levelF, levelG);
+    uint32_t var = static_cast<uint32_t>(levelToVar[top]);
+    BddNode f0 = levelF == top ? nodes[f].low : f;
+    BddNode f1 = levelF == top ? nodes[f].high : f;
+    BddNode g0 = levelG == top ? nodes[g].low : g;
+    BddNode g1 = levelG == top ? nodes[g].high : g;
+
+    BddNode low = Apply(op, f0, g0);
+    BddNode high = Apply(op, f1, g1);
+    BddNode result = MakeNode(var, low, high);
+    cache[slot] = CacheEntry{ op, f, g, result };
+    return result;
+}
+
+BddNode BddManager::MakeNode(uint32_t var, BddNode low, BddNode high) {
+    if (low == high) return low;
+    Subtable& table = subtables[var];
+    size_t bucket = Hash(low, high, table.buckets.size() - 1);
+    for (BddNode f = table.buckets[bucket]; f != NO_NODE; f = nodes[f].next) {
+        if (nodes[f].low == low && nodes[f].high == high) return f;
+    }
+
+    BddNode f = AllocateNode();
+    Node& node = nodes[f];
+    node.var = var;
+    node.low = low;
+    node.high = high;
+    node.ref = 0;
+    if (low > ONE) nodes[low].ref++;
+    if (high > ONE) nodes[high].ref++;
+    Insert(f);
+    return f;
+}
+
+BddNode BddManager::AllocateNode() {
+    if (freeList != NO_NODE) {
+        BddNode f = freeList;
+        freeList = nodes[f].next;
+        return f;
+    }
+    nodes.push_back(Node{ FREE_VAR, ZERO, ZERO, NO_NODE, 0 });
+    return static_cast<BddNode>(nodes.size() - 1);
+}
+
+void BddManager::Insert(BddNode f) {
+    Subtable& table = subtables[nodes[f].var];
+    if (table.count >= table.buckets.size() * 2) GrowSubtable(table);
+    size_t bucket = Hash(nodes[f].low, nodes[f].high, table.buckets.size() - 1);
+    nodes[f].next = table.buckets[bucket];
+    table.buckets[bucket] = f;
+    table.count++;
+    liveNodes++;
+}
+
+void BddManager::Remove(BddNode f) {
+    Subtable& table = subtables[nodes[f].var];
+    BddNode* link = &table.buckets[Hash(nodes[f].low, nodes[f].high, table.buckets.size() - 1)];
+    while (*link != f) link = &nodes[*link].next;
+    *link = nodes[f].next;
+    table.count--;
+    liveNodes--;
+}
+
+void BddManager::GrowSubtable(Subtable& table) {
+    std::vector<BddNode> buckets(table.buckets.size() * 2, NO_NODE);
+    for (BddNode head : table.buckets) {
+        for (BddNode f = head; f != NO_NODE;) {
+            BddNode next = nodes[f].next;
+            size_t bucket = Hash(nodes[f].low, nodes[f].high, buckets.size() - 1);
+            nodes[f].next = buckets[bucket];
+            buckets[bucket] = f;
+            f = next;
+        }
+    }
+    table.buckets.swap(buckets);
+}
+
+// 释放无引用的结点，并递归释放因此失去引用的子结点
+void BddManager::DerefAndFree(BddNode f) {
+    std::vector<BddNode> pending;
+    pending.push_back(f);
+    while (!pending.empty()) {
+        BddNode n = pending.back();
+        pending.pop_back();
+        if (n <= ONE || --nodes[n].ref != 0) continue;
+        Remove(n);
+        pending.push_back(nodes[n].low);
+        pending.push_back(nodes[n].high);
+        nodes[n].var = FREE_VAR;
+        nodes[n].next = freeList;
+        freeList = n;
+    }
+}
+
+void BddManager::ClearCache() {
+    for (CacheEntry& entry : cache) entry.op = OP_NONE;
+}
+
+void BddManager::CollectGarbage() {
+    // 自顶向下逐层回收：释放一个结点只会影响更低层的子结点
+    std::vector<BddNode> dead;
+    for (int level = 0; level < GetVariableCount(); ++level) {
+        dead.clear();
+        for (BddNode head : subtables[levelToVar[level]].buckets) {
+            for (BddNode f = head; f != NO_NODE; f = nodes[f].next) {
+                if (nodes[f].ref == 0) dead.push_back(f);
+            }
+        }
+        for (BddNode f : dead) {
+            nodes[f].ref = 1;
+            DerefAndFree(f);
+        }
+    }
+    ClearCache();
+    collections++;
+}
+
+bool BddManager::MaybeCollectGarbage() {
+    if (liveNodes < gcThreshold) return false;
+    CollectGarbage();
+    gcThreshold = std::max<size_t>(DEFAULT_GC_THRESHOLD, liveNodes * 2);
+    return true;
+}
+
+// 交换第 level 层和第 level+1 层的变量，结点原地改写，函数不变
+void BddManager::SwapLevels(int level) {
+    uint32_t x = static_cast<uint32_t>(levelToVar[level]);
+    uint32_t y = static_cast<uint32_t>(levelToVar[level + 1]);
+
+    // 取出依赖 y 的 x 结点；不依赖 y 的 x 结点保持原样，换层后仍然有效
+    std::vector<BddNode> moved;
+    for (BddNode head : subtables[x].buckets) {
+        for (BddNode f = head; f != NO_NODE; f = nodes[f].next) {
+            if (nodes[nodes[f].low].var == y || nodes[nodes[f].high].var == y) moved.push_back(f);
+        }
+    }
+    for (BddNode f : moved) Remove(f);
+
+    std::swap(levelToVar[level], levelToVar[level + 1]);
+    varToLevel[x] = level + 1;
+    varToLevel[y] = level;
+
+    for (BddNode f : moved) {
+        BddNode f0 = nodes[f].low, f1 = nodes[f].high;
+        bool split0 = nodes[f0].var == y, split1 = nodes[f1].var == y;
+        BddNode f00 = split0 ? nodes[f0].low : f0, f01 = split0 ? nodes[f0].high : f0;
+        BddNode f10 = split1 ? nodes[f1].low : f1, f11 = split1 ? nodes[f1].high : f1;
+
+        // f = y ? (x ? f11 : f01) : (x ? f10 : f00)
+        BddNode low = MakeNode(x, f00, f10);
+        if (low > ONE) nodes[low].ref++;
+        BddNode high = MakeNode(x, f01, f11);
+        if (high > ONE) nodes[high].ref++;
+
+        nodes[f].var = y;
+        nodes[f].low = low;
+        nodes[f].high = high;
+        Insert(f);
+        DerefAndFree(f0);
+        DerefAndFree(f1);
+    }
+}
+
+// 把变量移过所有层，停在结点总数最小的位置
+void BddManager::SiftVariable(int var) {
+    const int bottom = GetVariableCount() - 1;
+    size_t best = liveNodes;
+    int bestLevel = varToLevel[var];
+    size_t limit = static_cast<size_t>(best * MAX_GROWTH) + 1;
+
+    // 先移向较近的一端，再移向另一端
+    bool downFirst = bottom - varToLevel[var] < varToLevel[var];
+    for (int pass = 0; pass < 2; ++pass) {
+        bool down = (pass == 0) == downFirst;
+        while (down ? varToLevel[var] < bottom : varToLevel[var] > 0) {
+            SwapLevels(down ? varToLevel[var] : varToLevel[var] - 1);
+            if (liveNodes < best) {
+                best = liveNodes;
+                bestLevel = varToLevel[var];
+            }
+            if (liveNodes > limit) break;
+        }
+    }
+    while (varToLevel[var] < bestLevel) SwapLevels(varToLevel[var]);
+    while (varToLevel[var] > bestLevel) SwapLevels(varToLevel[var] - 1);
+}
+
+void BddManager::Reorder() {
+    CollectGarbage();
+    if (GetVariableCount() < 2) return;
+
+    // 结点多的变量先筛选
+    std::vector<int> vars(GetVariableCount());
+    for (int var = 0; var < GetVariableCount(); ++var) vars[var] = var;
+    std::stable_sort(vars.begin(), vars.end(), [this](int a, int b) {
+        return subtables[a].count > subtables[b].count;
+    });
+    for (int var : vars) SiftVariable(var);
+
+    ClearCache();
+    reorders++;
+}
+
+bool BddManager::MaybeReorder() {
+    if (!autoReorder || liveNodes < reorderThreshold) return false;
+    // 阈值较低，结点数中可能大半是无引用结点：先回收，只有真正增长时才重排
+    CollectGarbage();
+    if (liveNodes < reorderThreshold) return false;
+    Reorder();
+    reorderThreshold = std::max<size_t>(MIN_REORDER_THRESHOLD, liveNodes * 2);
+    return true;
+}
+
+double BddManager::SatCount(BddNode f) const {
+    // count[n]：在 n 所在层及以下的变量上满足 n 的赋值数
+    std::unordered_map<BddNode, double> count;
+    count[ZERO] = 0.0;
+    count[ONE] = 1.0;
+    std::vector<BddNode> pending;
+    pending.push_back(f);
+    while (!pending.empty()) {
+        BddNode n = pending.back();
+        if (count.count(n)) {
+            pending.pop_back();
+            continue;
+        }
+        BddNode low = nodes[n].low, high = nodes[n].high;
+        auto lowIt = count.find(low), highIt = count.find(high);
+        if (lowIt == count.end() || highIt == count.end()) {
+            if (lowIt == count.end()) pending.push_back(low);
+            if (highIt == count.end()) pending.push_back(high);
+            continue;
+        }
+        // 先算出结果再插入：插入可能重新散列，使 lowIt / highIt 失效
+        int level = Level(n);
+        double value = std::ldexp(lowIt->second, Level(low) - level - 1) +
+            std::ldexp(highIt->second, Level(high) - level - 1);
+        count.emplace(n, value);
+        pending.pop_back();
+    }
+    return std::ldexp(count[f], Level(f));
+}
+
+bool BddManager::AnySat(BddNode f, std::vector<int>& assignment) const {
+    assignment.assign(GetVariableCount(), -1);
+    if (f == ZERO) return false;
+    while (f > ONE) {
+        // 约简后的非零结点至少有一个子结点不恒为 0
+        bool takeHigh = nodes[f].high != ZERO;
+        assignment[nodes[f].var] = takeHigh ? 1 : 0;
+        f = takeHigh ? nodes[f].high : nodes[f].low;
+    }
+    return true;
+}
+
+bool BddManager::Evaluate(BddNode f, const std::vector<bool>& values) const {
+    while (f > ONE) f = values[nodes[f].var] ? nodes[f].high : nodes[f].low;
+    return f == ONE;
+}
+
+size_t BddManager::GetNodeCount(BddNode f) const {
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<BddNode> pending;
+    size_t count = 0;
+    pending.push_back(f);
+    while (!pending.empty()) {
+        BddNode n = pending.back();
+        pending.pop_back();
+        if (n <= ONE || visited[n]) continue;
+        visited[n] = true;
+        count++;
+        pending.push_back(nodes[n].low);
+        pending.push_back(nodes[n].high);
+    }
+    return count;
+}
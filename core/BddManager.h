@@ -0,0 +1,140 @@
+#pragma once
+#ifndef BDDMANAGER_H
+#define BDDMANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// BDD 结点编号；0 和 1 是两个常量结点
+typedef uint32_t BddNode;
+
+// 约简有序二元决策图（ROBDD）。每个变量一张唯一表保证同一函数只有一个结点，
+// 运算结果记在直接映射的计算表里。结点带引用计数：父结点和外部引用各算一次，
+// 计数为 0 的结点在垃圾回收时释放。变量顺序可用筛选法（sifting）动态调整，
+// 调整时结点原地改写，外部持有的结点编号保持有效。
+//
+// 约定：运算返回的结点不带引用；需要跨越 CollectGarbage/Reorder 保留的结点必须先 Ref。
+// 垃圾回收和重排只在显式调用（或 Maybe* 系列）时发生，不会在运算中途发生
+class BddManager {
+public:
+    enum : BddNode { ZERO = 0, ONE = 1 };
+
+    // 默认阈值：结点数超过时触发垃圾回收；自动重排在结点数达到 MIN_REORDER_THRESHOLD 时第一次进行，
+    // 之后在结点数翻倍（相对上次重排后的结点数）时再进行，画布上的小电路也会按需重排
+    enum : size_t { DEFAULT_GC_THRESHOLD = 1 << 16, MIN_REORDER_THRESHOLD = 1 << 8 };
+
+    explicit BddManager(int variableCount = 0);
+
+    // 在最底层添加一个变量，返回变量编号
+    int AddVariable();
+    int GetVariableCount() const { return static_cast<int>(varToLevel.size()); }
+
+    // 设置初始变量顺序（order[level] 为该层的变量）；只能在创建任何结点之前调用
+    bool SetOrder(const std::vector<int>& order);
+    int GetLevel(int var) const { return varToLevel[var]; }
+    int GetVariableAtLevel(int level) const { return levelToVar[level]; }
+
+    // 基本运算
+    BddNode Variable(int var);
+    BddNode Not(BddNode f) { return Apply(OP_XOR, f, ONE); }
+    BddNode And(BddNode f, BddNode g) { return Apply(OP_AND, f, g); }
+    BddNode Or(BddNode f, BddNode g) { return Apply(OP_OR, f, g); }
+    BddNode Xor(BddNode f, BddNode g) { return Apply(OP_XOR, f, g); }
+
+    // 外部引用
+    void Ref(BddNode f) {
+        if (f > ONE) nodes[f].ref++;
+    }
+    void Deref(BddNode f) {
+        if (f > ONE) nodes[f].ref--;
+    }
+
+    // 查询
+    static bool IsConstant(BddNode f) { return f <= ONE; }
+    int GetTopVariable(BddNode f) const { return f <= ONE ? -1 : static_cast<int>(nodes[f].var); }
+    BddNode GetLow(BddNode f) const { return nodes[f].low; }
+    BddNode GetHigh(BddNode f) const { return nodes[f].high; }
+
+    // 满足 f 的赋值数（在全部变量上计数）
+    double SatCount(BddNode f) const;
+    // 任取一个满足 f 的赋值：assignment[var] 为 0、1 或 -1（无关）；f 恒为 0 时返回 false
+    bool AnySat(BddNode f, std::vector<int>& assignment) const;
+    // 按变量值求 f
+    bool Evaluate(BddNode f, const std::vector<bool>& values) const;
+    // f 可达的非常量结点数
+    size_t GetNodeCount(BddNode f) const;
+    // 唯一表中的结点总数（含尚未回收的无引用结点）
+    size_t GetLiveNodeCount() const { return liveNodes; }
+
+    // 内存管理与变量重排
+    void CollectGarbage();
+    bool MaybeCollectGarbage();
+    void Reorder();
+    bool MaybeReorder();
+    void SetAutoReorder(bool enable) { autoReorder = enable; }
+    size_t GetCollectionCount() const { return collections; }
+    size_t GetReorderCount() const { return reorders; }
+
+private:
+    enum Op : uint32_t { OP_AND, OP_OR, OP_XOR, OP_NONE = ~0u };
+    enum : uint32_t { TERMINAL_VAR = ~0u, FREE_VAR = ~0u - 1, NO_NODE = ~0u };
+    enum : size_t { CACHE_SIZE = 1 << 18 };
+
+    struct Node {
+        uint32_t var;   // 变量编号（常量结点为 TERMINAL_VAR，空闲结点为 FREE_VAR）
+        BddNode low;    // 变量为 0 时的子结点
+        BddNode high;   // 变量为 1 时的子结点
+        BddNode next;   // 唯一表冲突链 / 空闲链表
+        uint32_t ref;   // 引用计数
+    };
+
+    // 一个变量的唯一表：按 (low, high) 散列的链表
+    struct Subtable {
+        std::vector<BddNode> buckets;
+        size_t count = 0;
+    };
+
+    struct CacheEntry {
+        uint32_t op;
+        BddNode f;
+        BddNode g;
+        BddNode result;
+    };
+
+    int Level(BddNode f) const {
+        return f <= ONE ? GetVariableCount() : varToLevel[nodes[f].var];
+    }
+
+    BddNode Apply(Op op, BddNode f, BddNode g);
+    BddNode MakeNode(uint32_t var, BddNode low, BddNode high);
+    BddNode AllocateNode();
+    void Insert(BddNode f);
+    void Remove(BddNode f);
+    void GrowSubtable(Subtable& table);
+    void DerefAndFree(BddNode f);
+    void ClearCache();
+
+    void SwapLevels(int level);
+    void SiftVariable(int var);
+
+    static size_t Hash(BddNode low, BddNode high, size_t mask) {
+        uint64_t h = (uint64_t(low) << 32 | high) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    std::vector<Node> nodes;            // 结点存储（0、1 为常量结点）
+    BddNode freeList;                   // 空闲结点链表
+    std::vector<Subtable> subtables;    // 每个变量的唯一表
+    std::vector<int> varToLevel;        // 变量 -> 层
+    std::vector<int> levelToVar;        // 层 -> 变量
+    std::vector<CacheEntry> cache;      // 计算表
+    size_t liveNodes;                   // 唯一表中的结点数
+    size_t gcThreshold;
+    size_t reorderThreshold;
+    bool autoReorder;
+    size_t collections;
+    size_t reorders;
+};
+
+#endif
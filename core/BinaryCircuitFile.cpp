@@ -0,0 +1,235 @@
+#include "BinaryCircuitFile.h"
+
+#include <cstring>
+#include "AtomicFile.h"
+#include "FilePath.h"
+#include "PinLayout.h"
+
+namespace {
+
+    const char MAGIC[4] = { 'C', 'I', 'R', 'B' };
+
+    bool Fail(std::string* error, const std::string& message) {
+        if (error) *error = message;
+        return false;
+    }
+
+    bool IsLittleEndian() {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+    }
+
+    // 每种元件的引脚下标 -> (是否为输入, 在 inputs 或 outputs 中的下标)，按类型缓存，避免逐个元件生成布局
+    struct PinPort {
+        bool input;
+        int port;
+    };
+
+    class PortTable {
+    public:
+        const std::vector<PinPort>& Get(ElementType type) {
+            size_t t = static_cast<size_t>(type);
+            if (t >= ports.size()) {
+                ports.resize(t + 1);
+                built.resize(t + 1, false);
+            }
+            if (!built[t]) {
+                int inputs = 0, outputs = 0;
+                for (const PinOffset& offset : GetPinLayout(type)) {
+                    ports[t].push_back(PinPort{ offset.input, offset.input ? inputs++ : outputs++ });
+                }
+                built[t] = true;
+            }
+            return ports[t];
+        }
+
+    private:
+        std::vector<std::vector<PinPort>> ports;
+        std::vector<bool> built;
+    };
+
+}
+
+bool BinaryCircuitFile::IsBinaryFileName(const std::string& filename) {
+    const std::string extension = GetExtension();
+    return filename.size() >= extension.size() &&
+        filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+bool BinaryCircuitFile::IsBinaryFile(const std::string& filename) {
+    std::FILE* file = FilePath::Open(filename, "rb");
+    if (!file) return false;
+    char magic[sizeof(MAGIC)];
+    size_t read = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+    return IsBinaryData(magic, read);
+}
+
+bool BinaryCircuitFile::IsBinaryData(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BinaryCircuitWriter::Reserve(size_t elementCount, size_t wireCount) {
+    elements.reserve(elements.size() + elementCount);
+    wires.reserve(wires.size() + wireCount);
+}
+
+void BinaryCircuitWriter::AddElement(ElementType type, int x, int y, bool value, const std::string& attributes) {
+    BinaryElementRecord record;
+    record.type = static_cast<uint16_t>(type);
+    record.flags = value ? BinaryCircuitFile::FLAG_VALUE : 0;
+    record.x = x;
+    record.y = y;
+    record.attributeOffset = static_cast<uint32_t>(strings.size());
+    record.attributeLength = static_cast<uint32_t>(attributes.size());
+    strings += attributes;
+    elements.push_back(record);
+}
+
+void BinaryCircuitWriter::AddWire(uint32_t driverElement, uint16_t driverPin, uint32_t readerElement, uint16_t readerPin) {
+    wires.push_back(BinaryWireRecord{ driverElement, readerElement, driverPin, readerPin });
+}
+
+void BinaryCircuitWriter::AddNetlist(const Netlist& netlist) {
+    const auto& netlistElements = netlist.GetElements();
+    const uint32_t first = static_cast<uint32_t>(elements.size());
+    PortTable ports;
+
+    // 线网 -> 驱动它的元件和引脚下标
+    std::vector<std::pair<uint32_t, uint16_t>> drivers(netlist.GetNetCount(), std::make_pair(~0u, uint16_t(0)));
+    for (size_t i = 0; i < netlistElements.size(); ++i) {
+        const NetlistElement& element = netlistElements[i];
+        if (element.type == TYPE_INPUT || element.type == TYPE_OUTPUT) {
+            // 与 CircuitFile::Format 相同：输入输出元件的第一个附加字段以 value 为准
+            size_t comma = element.attributes.find(',');
+            std::string attributes = std::string(element.value ? "1" : "0") + ",";
+            if (comma != std::string::npos) attributes += element.attributes.substr(comma + 1);
+            AddElement(element.type, element.x, element.y, element.value, attributes);
+        }
+        else {
+            AddElement(element.type, element.x, element.y, element.value, element.attributes);
+        }
+        const auto& table = ports.Get(element.type);
+        for (size_t pin = 0; pin < table.size(); ++pin) {
+            if (table[pin].input || table[pin].port >= static_cast<int>(element.outputs.size())) continue;
+            drivers[element.outputs[table[pin].port]] = std::make_pair(first + static_cast<uint32_t>(i), static_cast<uint16_t>(pin));
+        }
+    }
+
+    for (size_t i = 0; i < netlistElements.size(); ++i) {
+        const NetlistElement& element = netlistElements[i];
+        const auto& table = ports.Get(element.type);
+        for (size_t pin = 0; pin < table.size(); ++pin) {
+            if (!table[pin].input || table[pin].port >= static_cast<int>(element.inputs.size())) continue;
+            int net = element.inputs[table[pin].port];
+            if (net == Netlist::CONST_ZERO_NET || drivers[net].first == ~0u) continue;
+            AddWire(drivers[net].first, drivers[net].second, first + static_cast<uint32_t>(i), static_cast<uint16_t>(pin));
+        }
+    }
+}
+
+uint64_t BinaryCircuitWriter::GetFileSize() const {
+    return sizeof(BinaryCircuitHeader) + elements.size() * sizeof(BinaryElementRecord) +
+        wires.size() * sizeof(BinaryWireRecord) + strings.size();
+}
+
+bool BinaryCircuitWriter::Save(const std::string& filename, std::string* error) const {
+    if (!IsLittleEndian()) return Fail(error, "binary circuit files require a little-endian host");
+    BinaryCircuitHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = BinaryCircuitFile::VERSION;
+    header.elementCount = static_cast<uint32_t>(elements.size());
+    header.wireCount = static_cast<uint32_t>(wires.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+    header.reserved = 0;
+
+    AtomicFileWriter file;
+    if (!file.Open(filename, error)) return false;
+    file.Write(&header, sizeof(header));
+    file.Write(elements.data(), elements.size() * sizeof(BinaryElementRecord));
+    file.Write(wires.data(), wires.size() * sizeof(BinaryWireRecord));
+    file.Write(strings);
+    return file.Commit(error);
+}
+
+bool BinaryCircuitReader::Open(const std::string& filename, std::string* error) {
+    header = nullptr;
+    if (!file.Open(filename, error)) return false;
+    if (!Validate(error)) {
+        header = nullptr;
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool BinaryCircuitReader::Validate(std::string* error) {
+    const char* data = file.GetData();
+    const size_t size = file.GetSize();
+    if (!BinaryCircuitFile::IsBinaryData(data, size)) return Fail(error, "not a binary circuit file");
+    if (!IsLittleEndian()) return Fail(error, "binary circuit files require a little-endian host");
+    if (size < sizeof(BinaryCircuitHeader)) return Fail(error, "truncated binary circuit file");
+    header = reinterpret_cast<const BinaryCircuitHeader*>(data);
+    if (header->version > BinaryCircuitFile::VERSION) {
+        return Fail(error, "binary circuit file version " + std::to_string(header->version) + " is not supported");
+    }
+
+    // 各表紧接着存放，总长度必须与文件大小一致
+    const uint64_t elementBytes = uint64_t(header->elementCount) * sizeof(BinaryElementRecord);
+    const uint64_t wireBytes = uint64_t(header->wireCount) * sizeof(BinaryWireRecord);
+    if (sizeof(BinaryCircuitHeader) + elementBytes + wireBytes + header->stringBytes != size) {
+        return Fail(error, "corrupt binary circuit file (table sizes do not match the file size)");
+    }
+    elements = reinterpret_cast<const BinaryElementRecord*>(data + sizeof(BinaryCircuitHeader));
+    wires = reinterpret_cast<const BinaryWireRecord*>(data + sizeof(BinaryCircuitHeader) + elementBytes);
+    strings = data + sizeof(BinaryCircuitHeader) + elementBytes + wireBytes;
+
+    for (uint32_t i = 0; i < header->elementCount; ++i) {
+        if (uint64_t(elements[i].attributeOffset) + elements[i].attributeLength > header->stringBytes) {
+            return Fail(error, "corrupt binary circuit file (element " + std::to_string(i) + ")");
+        }
+    }
+    for (uint32_t i = 0; i < header->wireCount; ++i) {
+        if (wires[i].driverElement >= header->elementCount || wires[i].readerElement >= header->elementCount) {
+            return Fail(error, "corrupt binary circuit file (wire " + std::to_string(i) + ")");
+        }
+    }
+    return true;
+}
+
+void BinaryCircuitReader::ToNetlist(Netlist& netlist) const {
+    netlist.Clear();
+    auto& netlistElements = netlist.GetElements();
+    netlistElements.reserve(header->elementCount);
+    PortTable ports;
+
+    // 文件中的元件下标 -> 网表下标（无法识别的类型为 -1）
+    std::vector<int> index(header->elementCount, -1);
+    for (uint32_t i = 0; i < header->elementCount; ++i) {
+        const BinaryElementRecord& record = elements[i];
+        if (record.type > TYPE_REGISTER) continue;
+        ElementType type = static_cast<ElementType>(record.type);
+        const auto& table = ports.Get(type);
+        if (table.empty()) continue;
+        index[i] = netlist.AddElement(type, (record.flags & BinaryCircuitFile::FLAG_VALUE) != 0, record.x, record.y);
+        NetlistElement& element = netlistElements[index[i]];
+        element.attributes.assign(strings + record.attributeOffset, record.attributeLength);
+        for (const PinPort& pin : table) {
+            if (pin.input) element.inputs.push_back(Netlist::CONST_ZERO_NET);
+            else element.outputs.push_back(netlist.AddNet());
+        }
+    }
+
+    for (uint32_t i = 0; i < header->wireCount; ++i) {
+        const BinaryWireRecord& wire = wires[i];
+        int driver = index[wire.driverElement], reader = index[wire.readerElement];
+        if (driver < 0 || reader < 0) continue;
+        const auto& driverPorts = ports.Get(netlistElements[driver].type);
+        const auto& readerPorts = ports.Get(netlistElements[reader].type);
+        if (wire.driverPin >= driverPorts.size() || wire.readerPin >= readerPorts.size()) continue;
+        const PinPort& from = driverPorts[wire.driverPin];
+        const PinPort& to = readerPorts[wire.readerPin];
+        if (from.input || !to.input) continue;
+        netlistElements[reader].inputs[to.port] = netlistElements[driver].outputs[from.port];
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef BINARYCIRCUITFILE_H
+#define BINARYCIRCUITFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Netlist.h"
+
+// 二进制电路文件（.circb）：文件头之后依次是定长的元件表、导线表和字符串表，全部为小端序。
+// 导线记录元件下标和引脚下标（GetPins() / GetPinLayout 的顺序），加载时不需要按坐标查找引脚；
+// 各表的位置由文件头中的数量直接算出，文件映射到内存后按记录读取，不逐字段分配内存
+
+// 文件头（24 字节）
+struct BinaryCircuitHeader {
+    char magic[4];           // "CIRB"
+    uint32_t version;        // 格式版本，读取时拒绝更高的版本
+    uint32_t elementCount;
+    uint32_t wireCount;
+    uint32_t stringBytes;    // 字符串表的字节数
+    uint32_t reserved;
+};
+
+// 元件记录（20 字节）
+struct BinaryElementRecord {
+    uint16_t type;             // ElementType
+    uint16_t flags;            // FLAG_VALUE：输入输出元件的当前值
+    int32_t x;
+    int32_t y;
+    uint32_t attributeOffset;  // 坐标之后的其余字段（与文本格式相同）在字符串表中的位置
+    uint32_t attributeLength;
+};
+
+// 导线记录（12 字节）：从驱动元件的输出引脚到读取元件的输入引脚
+struct BinaryWireRecord {
+    uint32_t driverElement;
+    uint32_t readerElement;
+    uint16_t driverPin;
+    uint16_t readerPin;
+};
+
+static_assert(sizeof(BinaryCircuitHeader) == 24, "binary circuit header must be 24 bytes");
+static_assert(sizeof(BinaryElementRecord) == 20, "binary element record must be 20 bytes");
+static_assert(sizeof(BinaryWireRecord) == 12, "binary wire record must be 12 bytes");
+
+class BinaryCircuitFile {
+public:
+    enum : uint32_t { VERSION = 1 };
+    enum : uint16_t { FLAG_VALUE = 1 };
+
+    static const char* GetExtension() { return ".circb"; }
+
+    // 按扩展名判断保存格式
+    static bool IsBinaryFileName(const std::string& filename);
+    // 按文件开头的标识判断加载格式
+    static bool IsBinaryFile(const std::string& filename);
+    static bool IsBinaryData(const char* data, size_t size);
+};
+
+// 在内存中组装各表，最后一次写出
+class BinaryCircuitWriter {
+public:
+    void Reserve(size_t elementCount, size_t wireCount);
+    void AddElement(ElementType type, int x, int y, bool value, const std::string& attributes);
+    void AddWire(uint32_t driverElement, uint16_t driverPin, uint32_t readerElement, uint16_t readerPin);
+
+    // 添加网表中的全部元件，并为每个连接的输入引脚添加一根来自其驱动引脚的导线
+    void AddNetlist(const Netlist& netlist);
+
+    // 已添加的记录，与 BinaryCircuitReader 的访问方式相同
+    uint32_t GetElementCount() const { return static_cast<uint32_t>(elements.size()); }
+    uint32_t GetWireCount() const { return static_cast<uint32_t>(wires.size()); }
+    const BinaryElementRecord& GetElement(uint32_t i) const { return elements[i]; }
+    const BinaryWireRecord& GetWire(uint32_t i) const { return wires[i]; }
+    const char* GetAttributes(uint32_t i) const { return strings.data() + elements[i].attributeOffset; }
+
+    // 写成文件后的字节数
+    uint64_t GetFileSize() const;
+
+    // 先写临时文件再替换目标文件（见 AtomicFileWriter）
+    bool Save(const std::string& filename, std::string* error = nullptr) const;
+
+private:
+    std::vector<BinaryElementRecord> elements;
+    std::vector<BinaryWireRecord> wires;
+    std::string strings;
+};
+
+// 映射文件并校验各表的范围；之后的读取不再检查下标（引脚下标由使用者按元件类型检查）
+class BinaryCircuitReader {
+public:
+    BinaryCircuitReader() : header(nullptr), elements(nullptr), wires(nullptr), strings(nullptr) {}
+
+    bool Open(const std::string& filename, std::string* error = nullptr);
+
+    uint32_t GetElementCount() const { return header->elementCount; }
+    uint32_t GetWireCount() const { return header->wireCount; }
+    size_t GetFileSize() const { return file.GetSize(); }
+    const BinaryElementRecord& GetElement(uint32_t i) const { return elements[i]; }
+    const BinaryWireRecord& GetWire(uint32_t i) const { return wires[i]; }
+    const char* GetAttributes(uint32_t i) const { return strings + elements[i].attributeOffset; }
+
+    // 构建网表；无法识别的元件及其导线被忽略（与文本格式的加载行为一致）
+    void ToNetlist(Netlist& netlist) const;
+
+private:
+    bool Validate(std::string* error);
+
+    MappedFile file;
+    const BinaryCircuitHeader* header;
+    const BinaryElementRecord* elements;
+    const BinaryWireRecord* wires;
+    const char* strings;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef CIRCUITBDD_H
+#define CIRCUITBDD_H
+
+#include <string>
+#include <vector>
+#include "BddManager.h"
+#include "CompiledCircuit.h"
+
+// 为组合电路的每个输出构建 BDD：变量 i 对应第 i 个输入元件。
+// 不需要枚举 2^n 行即可回答常量、可满足性和满足赋值数，适合输入很多的电路
+class CircuitBdd {
+public:
+    // 默认结点上限（约 80MB）；超过时放弃构建
+    enum : size_t { DEFAULT_NODE_LIMIT = 1 << 22 };
+
+    CircuitBdd() : nodeLimit(DEFAULT_NODE_LIMIT) {}
+
+    void SetNodeLimit(size_t nodes) { nodeLimit = nodes; }
+
+    bool Build(const Netlist& netlist, std::string* error = nullptr) {
+        CompiledCircuit circuit;
+        if (!circuit.Compile(netlist)) {
+            if (error) *error = circuit.GetError();
+            return false;
+        }
+        return Build(circuit, error);
+    }
+
+    bool Build(const CompiledCircuit& circuit, std::string* error = nullptr) {
+        const auto& program = circuit.GetProgram();
+        const auto& inputSlots = circuit.GetInputSlots();
+        const auto& outputSlots = circuit.GetOutputSlots();
+        manager = BddManager(static_cast<int>(inputSlots.size()));
+        manager.SetOrder(InitialOrder(circuit));
+        outputs.clear();
+
+        // 每个槽位的 BDD 及剩余读取次数；读取完毕的中间结果释放引用
+        std::vector<BddNode> slot(circuit.GetSlotCount(), BddManager::ZERO);
+        std::vector<uint32_t> uses(circuit.GetSlotCount(), 0);
+        for (const GateInstruction& instr : program) {
+            uses[instr.in0]++;
+            uses[instr.in1]++;
+        }
+        for (uint32_t out : outputSlots) uses[out]++;
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            if (inputSlots[i] == Netlist::CONST_ZERO_NET) continue;
+            slot[inputSlots[i]] = manager.Variable(static_cast<int>(i));
+            manager.Ref(slot[inputSlots[i]]);
+        }
+
+        for (const GateInstruction& instr : program) {
+            BddNode a = slot[instr.in0], b = slot[instr.in1], r;
+            switch (instr.opcode) {
+            case GATE_AND: r = manager.And(a, b); break;
+            case GATE_OR: r = manager.Or(a, b); break;
+            case GATE_NOT: r = manager.Not(a); break;
+            case GATE_XOR: r = manager.Xor(a, b); break;
+            case GATE_NAND: r = manager.Not(manager.And(a, b)); break;
+            default: r = manager.Not(manager.Or(a, b)); break;
+            }
+            slot[instr.out] = r;
+            if (uses[instr.out] > 0) manager.Ref(r);
+            if (--uses[instr.in0] == 0) manager.Deref(a);
+            if (--uses[instr.in1] == 0) manager.Deref(b);
+
+            // 只在两条指令之间回收和重排，此时所有仍需要的结点都持有引用
+            manager.MaybeCollectGarbage();
+            manager.MaybeReorder();
+            if (manager.GetLiveNodeCount() > nodeLimit) {
+                manager = BddManager();
+                if (error) *error = "BDD node limit exceeded";
+                return false;
+            }
+        }
+
+        for (uint32_t out : outputSlots) outputs.push_back(slot[out]);
+        manager.CollectGarbage();
+        return true;
+    }
+
+    BddManager& GetManager() { return manager; }
+    const BddManager& GetManager() const { return manager; }
+    size_t GetOutputCount() const { return outputs.size(); }
+    BddNode GetOutput(size_t output) const { return outputs[output]; }
+
+private:
+    // 初始变量顺序：从各输出出发深度优先遍历，先遇到的输入放在上层，
+    // 使同一个门的输入变量在顺序中相邻
+    static std::vector<int> InitialOrder(const CompiledCircuit& circuit) {
+        const auto& inputSlots = circuit.GetInputSlots();
+        std::vector<int> inputOfSlot(circuit.GetSlotCount(), -1);
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            if (inputSlots[i] != Netlist::CONST_ZERO_NET) inputOfSlot[inputSlots[i]] = static_cast<int>(i);
+        }
+        std::vector<const GateInstruction*> driver(circuit.GetSlotCount(), nullptr);
+        for (const GateInstruction& instr : circuit.GetProgram()) driver[instr.out] = &instr;
+
+        std::vector<int> order;
+        std::vector<bool> visited(circuit.GetSlotCount(), false), placed(inputSlots.size(), false);
+        std::vector<uint32_t> pending;
+        for (uint32_t out : circuit.GetOutputSlots()) {
+            pending.push_back(out);
+            while (!pending.empty()) {
+                uint32_t s = pending.back();
+                pending.pop_back();
+                if (visited[s]) continue;
+                visited[s] = true;
+                if (inputOfSlot[s] >= 0) {
+                    order.push_back(inputOfSlot[s]);
+                    placed[inputOfSlot[s]] = true;
+                }
+                else if (driver[s]) {
+                    pending.push_back(driver[s]->in1);
+                    pending.push_back(driver[s]->in0);
+                }
+            }
+        }
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            if (!placed[i]) order.push_back(static_cast<int>(i));
+        }
+        return order;
+    }
+
+    BddManager manager;
+    std::vector<BddNode> outputs;  // 每个输出的 BDD（持有引用）
+    size_t nodeLimit;
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "CircuitFile.h"
+
+#include <chrono>
+#include <cstring>
+#include "AtomicFile.h"
+#include "BinaryCircuitFile.h"
+#include "CoordinateIndex.h"
+#include "PinLayout.h"
+
+namespace {
+
+    // 文件中的一个引脚：所在元件及其在 inputs 或 outputs 中的位置
+    struct PinRecord {
+        bool input;
+        int element;
+        int port;  // 在元件 inputs 或 outputs 中的下标
+    };
+
+    bool IsInputOutput(ElementType type) {
+        return type == TYPE_INPUT || type == TYPE_OUTPUT;
+    }
+
+    // 边读边建网表：元件行立即创建元件、为输出引脚分配线网并把引脚加入坐标索引；
+    // 连接行和导线行先记下，读完后连接：连接行按元件序号和引脚下标直接取引脚，
+    // 旧格式的导线行在坐标索引中查找两端（两种行都可能出现在它连接的元件之前）
+    class NetlistTextBuilder {
+    public:
+        explicit NetlistTextBuilder(Netlist& netlist) : netlist(netlist), index(CircuitFile::PIN_TOLERANCE) {
+            netlist.Clear();
+        }
+
+        void AddElement(const CircuitTextReader::ElementLine& line) {
+            // 类型号可能是任意整数，越界的行与画布一样跳过，不能拿来扩充布局缓存
+            if (line.type < TYPE_INPUT || line.type > TYPE_REGISTER) return;
+            ElementType type = static_cast<ElementType>(line.type);
+            const std::vector<PinOffset>& layout = Layout(type);
+            if (layout.empty()) return;
+
+            int element = netlist.AddElement(type, false, line.x, line.y);
+            if (line.index >= lineElements.size()) lineElements.resize(line.index + 1, -1);
+            lineElements[line.index] = element;
+            pinBase.push_back(static_cast<int>(pins.size()));
+            NetlistElement& added = netlist.GetElements()[element];
+            added.attributes.assign(line.attributes, line.attributeLength);
+            if (IsInputOutput(type)) {
+                const char* comma = static_cast<const char*>(std::memchr(line.attributes, ',', line.attributeLength));
+                int value;
+                if (CircuitTextReader::ParseInt(line.attributes, comma ? comma : line.attributes + line.attributeLength, value)) {
+                    added.value = value != 0;
+                }
+            }
+
+            for (const PinOffset& offset : layout) {
+                PinRecord pin{ offset.input, element, 0 };
+                if (offset.input) {
+                    pin.port = static_cast<int>(added.inputs.size());
+                    added.inputs.push_back(Netlist::CONST_ZERO_NET);
+                }
+                else {
+                    pin.port = static_cast<int>(added.outputs.size());
+                    added.outputs.push_back(netlist.AddNet());
+                }
+                index.Add(line.x + offset.dx, line.y + offset.dy);
+                pins.push_back(pin);
+            }
+        }
+
+        void AddWire(const CircuitTextReader::WireLine& line) { wires.push_back(line); }
+        void AddLink(const CircuitTextReader::LinkLine& line) { links.push_back(line); }
+
+        // 连接两端的引脚，输入引脚读取输出引脚的线网
+        void ConnectWires() {
+            for (const CircuitTextReader::LinkLine& link : links) {
+                Connect(LinkPin(link.fromElement, link.fromPin), LinkPin(link.toElement, link.toPin));
+            }
+            for (const CircuitTextReader::WireLine& wire : wires) {
+                Connect(index.Find(wire.x1, wire.y1), index.Find(wire.x2, wire.y2));
+            }
+        }
+
+    private:
+        // 元件行序号和引脚下标 -> pins 中的编号（找不到时为 -1）
+        int LinkPin(uint32_t line, uint32_t pin) const {
+            if (line >= lineElements.size() || lineElements[line] < 0) return -1;
+            int element = lineElements[line];
+            int end = element + 1 < static_cast<int>(pinBase.size()) ? pinBase[element + 1] : static_cast<int>(pins.size());
+            return pin < static_cast<uint32_t>(end - pinBase[element]) ? pinBase[element] + static_cast<int>(pin) : -1;
+        }
+
+        void Connect(int a, int b) {
+            if (a < 0 || b < 0 || pins[a].input == pins[b].input) return;
+            const PinRecord& driver = pins[a].input ? pins[b] : pins[a];
+            const PinRecord& reader = pins[a].input ? pins[a] : pins[b];
+            auto& elements = netlist.GetElements();
+            elements[reader.element].inputs[reader.port] = elements[driver.element].outputs[driver.port];
+        }
+
+        // 每种元件的引脚布局只生成一次
+        const std::vector<PinOffset>& Layout(ElementType type) {
+            size_t t = static_cast<size_t>(type);
+            if (t >= layouts.size()) {
+                layouts.resize(t + 1);
+                built.resize(t + 1, false);
+            }
+            if (!built[t]) {
+                layouts[t] = GetPinLayout(type);
+                built[t] = true;
+            }
+            return layouts[t];
+        }
+
+        Netlist& netlist;
+        std::vector<PinRecord> pins;  // 编号与坐标索引中的点相同
+        std::vector<int> pinBase;     // 网表元件 -> 其第一个引脚在 pins 中的编号
+        std::vector<int> lineElements;  // 元件行序号 -> 网表元件（无法识别的类型为 -1）
+        CoordinateIndex index;
+        std::vector<CircuitTextReader::WireLine> wires;
+        std::vector<CircuitTextReader::LinkLine> links;
+        std::vector<std::vector<PinOffset>> layouts;
+        std::vector<bool> built;
+    };
+
+}
+
+void CircuitFile::Parse(const std::string& text, Netlist& netlist) {
+    NetlistTextBuilder builder(netlist);
+    CircuitTextReader reader;
+    reader.ReadText(text.data(), text.size(),
+        [&](const CircuitTextReader::ElementLine& line) { builder.AddElement(line); },
+        [&](const CircuitTextReader::WireLine& line) { builder.AddWire(line); },
+        [&](const CircuitTextReader::LinkLine& line) { builder.AddLink(line); });
+    builder.ConnectWires();
+}
+
+std::string CircuitFile::Format(const Netlist& netlist) {
+    const auto& elements = netlist.GetElements();
+    std::string data;
+
+    // 元件行；输入输出元件的第一个附加字段为当前值
+    for (const NetlistElement& element : elements) {
+        data += std::to_string(element.type) + "," + std::to_string(element.x) + "," + std::to_string(element.y);
+        if (IsInputOutput(element.type)) {
+            size_t comma = element.attributes.find(',');
+            data += std::string(",") + (element.value ? "1" : "0") + ",";
+            if (comma != std::string::npos) data += element.attributes.substr(comma + 1);
+        }
+        else if (!element.attributes.empty()) {
+            data += "," + element.attributes;
+        }
+        data += "\n";
+    }
+
+    // 线网 -> 驱动它的元件序号和引脚下标
+    std::vector<std::pair<size_t, size_t>> drivers(netlist.GetNetCount());
+    std::vector<bool> driven(netlist.GetNetCount(), false);
+    for (size_t e = 0; e < elements.size(); ++e) {
+        std::vector<PinOffset> layout = GetPinLayout(elements[e].type);
+        size_t port = 0;
+        for (size_t pin = 0; pin < layout.size(); ++pin) {
+            if (layout[pin].input || port >= elements[e].outputs.size()) continue;
+            int net = elements[e].outputs[port++];
+            drivers[net] = std::make_pair(e, pin);
+            driven[net] = true;
+        }
+    }
+
+    // 每个连接的输入引脚一行，从驱动引脚指向它
+    for (size_t e = 0; e < elements.size(); ++e) {
+        std::vector<PinOffset> layout = GetPinLayout(elements[e].type);
+        size_t port = 0;
+        for (size_t pin = 0; pin < layout.size(); ++pin) {
+            if (!layout[pin].input || port >= elements[e].inputs.size()) continue;
+            int net = elements[e].inputs[port++];
+            if (net == Netlist::CONST_ZERO_NET || !driven[net]) continue;
+            data += "LINK," + std::to_string(drivers[net].first) + "," + std::to_string(drivers[net].second) + "," +
+                std::to_string(e) + "," + std::to_string(pin) + "\n";
+        }
+    }
+    return data;
+}
+
+bool CircuitFile::Load(const std::string& filename, Netlist& netlist, std::string* error, CircuitTextReader::Stats* stats) {
+    if (BinaryCircuitFile::IsBinaryFile(filename)) {
+        const auto start = std::chrono::steady_clock::now();
+        BinaryCircuitReader reader;
+        if (!reader.Open(filename, error)) return false;
+        reader.ToNetlist(netlist);
+        if (stats) {
+            *stats = CircuitTextReader::Stats();
+            stats->bytes = reader.GetFileSize();
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+
+    // 文本格式按块流式读取，不把整个文件读入内存
+    CircuitTextReader reader;
+    if (!reader.Open(filename, error)) return false;
+    NetlistTextBuilder builder(netlist);
+    bool ok = reader.Read(
+        [&](const CircuitTextReader::ElementLine& line) { builder.AddElement(line); },
+        [&](const CircuitTextReader::WireLine& line) { builder.AddWire(line); },
+        [&](const CircuitTextReader::LinkLine& line) { builder.AddLink(line); }, error);
+    builder.ConnectWires();
+    if (stats) *stats = reader.GetStats();
+    return ok;
+}
+
+bool CircuitFile::Save(const std::string& filename, const Netlist& netlist, std::string* error) {
+    if (BinaryCircuitFile::IsBinaryFileName(filename)) {
+        BinaryCircuitWriter writer;
+        writer.AddNetlist(netlist);
+        return writer.Save(filename, error);
+    }
+
+    AtomicFileWriter file;
+    if (!file.Open(filename, error)) return false;
+    file.Write(Format(netlist));
+    return file.Commit(error);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef CIRCUITFILE_H
+#define CIRCUITFILE_H
+
+#include <string>
+#include "CircuitTextReader.h"
+#include "Netlist.h"
+
+// 电路文件读写，不依赖 wxWidgets。文件格式与 CircuitCanvas::SaveCircuit/LoadCircuit 相同：
+// 每行一个元件（类型,x,y,其余字段），之后是 LINK,起点元件,起点引脚,终点元件,终点引脚 形式的连接，
+// 元件为元件行的序号、引脚为引脚布局中的下标；旧文件中 WIRE,x1,y1,x2,y2 形式的导线按引脚坐标匹配
+class CircuitFile {
+public:
+    // 匹配旧格式导线端点与引脚时的坐标容差
+    static const int PIN_TOLERANCE = 5;
+
+    // 从文本构建网表；无法识别的行和找不到引脚的导线被忽略（与画布加载行为一致）
+    static void Parse(const std::string& text, Netlist& netlist);
+
+    // 把网表写成文本；每个连接的输入引脚一个连接行，从驱动它的输出引脚指向它
+    static std::string Format(const Netlist& netlist);
+
+    // 以二进制标识开头的文件按 BinaryCircuitFile 的格式读取，否则按块流式解析文本；
+    // stats 非空时记录读取的字节数和耗时。扩展名为 .circb 时写成二进制格式
+    static bool Load(const std::string& filename, Netlist& netlist, std::string* error = nullptr,
+        CircuitTextReader::Stats* stats = nullptr);
+    static bool Save(const std::string& filename, const Netlist& netlist, std::string* error = nullptr);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "CircuitSnapshot.h"
+
+#include "AtomicFile.h"
+
+namespace {
+
+    // 文本按块写出，不在内存中拼出整个文件
+    const size_t WRITE_CHUNK = 1 << 20;
+
+    void AppendInt(std::string& out, int64_t value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        do {
+            *--p = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) *--p = '-';
+        out.append(p, end);
+    }
+
+}
+
+bool CircuitSnapshot::Save(const std::string& filename, std::string* error, uint64_t* bytes) const {
+    if (BinaryCircuitFile::IsBinaryFileName(filename)) {
+        if (!records.Save(filename, error)) return false;
+        if (bytes) *bytes = records.GetFileSize();
+        return true;
+    }
+    return SaveText(filename, error, bytes);
+}
+
+bool CircuitSnapshot::SaveText(const std::string& filename, std::string* error, uint64_t* bytes) const {
+    AtomicFileWriter file;
+    if (!file.Open(filename, error)) return false;
+
+    std::string chunk;
+    chunk.reserve(WRITE_CHUNK + 256);
+    auto flush = [&file, &chunk](bool force) {
+        if (force || chunk.size() >= WRITE_CHUNK) {
+            file.Write(chunk);
+            chunk.clear();
+        }
+    };
+
+    // 元件行：类型,x,y[,附加字段]
+    for (uint32_t i = 0; i < records.GetElementCount(); ++i) {
+        const BinaryElementRecord& element = records.GetElement(i);
+        AppendInt(chunk, element.type);
+        chunk += ',';
+        AppendInt(chunk, element.x);
+        chunk += ',';
+        AppendInt(chunk, element.y);
+        if (element.attributeLength > 0) {
+            chunk += ',';
+            chunk.append(records.GetAttributes(i), element.attributeLength);
+        }
+        chunk += '\n';
+        flush(false);
+    }
+
+    // 连接行：LINK,起点元件,起点引脚,终点元件,终点引脚
+    for (uint32_t i = 0; i < records.GetWireCount(); ++i) {
+        const BinaryWireRecord& wire = records.GetWire(i);
+        chunk += "LINK,";
+        AppendInt(chunk, wire.driverElement);
+        chunk += ',';
+        AppendInt(chunk, wire.driverPin);
+        chunk += ',';
+        AppendInt(chunk, wire.readerElement);
+        chunk += ',';
+        AppendInt(chunk, wire.readerPin);
+        chunk += '\n';
+        flush(false);
+    }
+    flush(true);
+
+    if (!file.Commit(error)) return false;
+    if (bytes) *bytes = file.GetBytesWritten();
+    return true;
+}
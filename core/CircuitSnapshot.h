@@ -0,0 +1,37 @@
+#pragma once
+#ifndef CIRCUITSNAPSHOT_H
+#define CIRCUITSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "BinaryCircuitFile.h"
+
+// 保存用的电路快照：元件和导线的纯数据副本，记录与二进制文件相同（元件下标 + 引脚下标）。
+// 界面线程只复制坐标、类型和少量附加字段，格式化和写文件留给保存线程；填好之后只读，可以跨线程共享
+class CircuitSnapshot {
+public:
+    void Reserve(size_t elementCount, size_t wireCount) { records.Reserve(elementCount, wireCount); }
+
+    // attributes 为序列化结果中坐标之后的其余字段（与文本格式相同），没有附加字段的元件为空
+    void AddElement(ElementType type, int x, int y, bool value, const std::string& attributes) {
+        records.AddElement(type, x, y, value, attributes);
+    }
+
+    void AddWire(uint32_t driverElement, uint16_t driverPin, uint32_t readerElement, uint16_t readerPin) {
+        records.AddWire(driverElement, driverPin, readerElement, readerPin);
+    }
+
+    uint32_t GetElementCount() const { return records.GetElementCount(); }
+    uint32_t GetWireCount() const { return records.GetWireCount(); }
+
+    // 按扩展名选择二进制或文本格式，先写临时文件再替换目标文件；bytes 非空时记录写入的字节数。
+    // 文本格式与 CircuitCanvas::SerializeCircuit 的输出相同
+    bool Save(const std::string& filename, std::string* error = nullptr, uint64_t* bytes = nullptr) const;
+
+private:
+    bool SaveText(const std::string& filename, std::string* error, uint64_t* bytes) const;
+
+    BinaryCircuitWriter records;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#pragma once
+#ifndef CIRCUITTEXTREADER_H
+#define CIRCUITTEXTREADER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#define CIRCUITTEXTREADER_FROM_CHARS 1
+#endif
+#include "FilePath.h"
+
+// 电路文本文件的流式解析。每行一个元件（类型,x,y,其余字段），之后是连接行
+// LINK,起点元件,起点引脚,终点元件,终点引脚（元件为文件中元件行的序号，引脚为 GetPins() / GetPinLayout 中的下标），
+// 旧文件中的导线行 WIRE,x1,y1,x2,y2 按引脚坐标匹配。
+// 文件按固定大小的块读入并逐行回调，不把整个文件读进一个字符串；数字字段直接在缓冲区上解析，
+// 不为每行或每个字段分配字符串。回调中的指针只在回调期间有效
+class CircuitTextReader {
+public:
+    // 元件行；坐标字段缺失或无法解析时为 0，attributes 为第三个逗号之后的其余字段（不含行尾空白）
+    struct ElementLine {
+        uint32_t index;  // 元件行的序号（从 0 开始），连接行按它引用元件
+        int type;
+        int x;
+        int y;
+        const char* line;
+        size_t lineLength;
+        const char* attributes;
+        size_t attributeLength;
+    };
+
+    // 导线行；四个坐标都能解析时才回调
+    struct WireLine {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+    };
+
+    // 连接行；四个字段都是非负整数时才回调
+    struct LinkLine {
+        uint32_t fromElement;
+        uint32_t fromPin;
+        uint32_t toElement;
+        uint32_t toPin;
+    };
+
+    // 读取的字节数、行数和耗时（从 Open 到读完）
+    struct Stats {
+        uint64_t bytes;
+        uint64_t lines;
+        double seconds;
+
+        Stats() : bytes(0), lines(0), seconds(0) {}
+        double GetMegabytesPerSecond() const { return seconds > 0 ? bytes / 1e6 / seconds : 0; }
+    };
+
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    CircuitTextReader() : file(nullptr), elementCount(0) {}
+    ~CircuitTextReader() { Close(); }
+    CircuitTextReader(const CircuitTextReader&) = delete;
+    CircuitTextReader& operator=(const CircuitTextReader&) = delete;
+
+    bool Open(const std::string& filename, std::string* error = nullptr) {
+        Close();
+        stats = Stats();
+        elementCount = 0;
+        start = std::chrono::steady_clock::now();
+        file = FilePath::Open(filename, "rb");
+        if (!file) {
+            if (error) *error = "cannot open " + filename;
+            return false;
+        }
+        return true;
+    }
+
+    void Close() {
+        if (file) std::fclose(file);
+        file = nullptr;
+    }
+
+    // 逐块读取已打开的文件，每个元件行调用 onElement(const ElementLine&)，每个导线行调用 onWire(const WireLine&)，
+    // 每个连接行调用 onLink(const LinkLine&)；跨块的行拼接后处理，超过块大小的行使缓冲区加倍
+    template <typename ElementHandler, typename WireHandler, typename LinkHandler>
+    bool Read(ElementHandler onElement, WireHandler onWire, LinkHandler onLink, std::string* error = nullptr) {
+        std::vector<char> buffer(CHUNK_SIZE);
+        size_t pending = 0;  // 缓冲区开头尚未处理的不完整行
+        bool ok = true;
+        for (;;) {
+            if (pending == buffer.size()) buffer.resize(buffer.size() * 2);
+            size_t count = std::fread(buffer.data() + pending, 1, buffer.size() - pending, file);
+            if (count == 0) {
+                if (std::ferror(file)) {
+                    if (error) *error = "read failed";
+                    ok = false;
+                }
+                break;
+            }
+            stats.bytes += count;
+            const char* begin = buffer.data();
+            const char* end = begin + pending + count;
+            const char* rest = ParseLines(begin, end, onElement, onWire, onLink);
+            pending = static_cast<size_t>(end - rest);
+            std::memmove(buffer.data(), rest, pending);
+        }
+        if (pending > 0) ParseLine(buffer.data(), buffer.data() + pending, onElement, onWire, onLink);
+        Close();
+        stats.seconds = Elapsed();
+        return ok;
+    }
+
+    // 解析内存中的文本（撤销记录等），行为与 Read 相同
+    template <typename ElementHandler, typename WireHandler, typename LinkHandler>
+    void ReadText(const char* data, size_t size, ElementHandler onElement, WireHandler onWire, LinkHandler onLink) {
+        stats = Stats();
+        elementCount = 0;
+        start = std::chrono::steady_clock::now();
+        stats.bytes = size;
+        const char* rest = ParseLines(data, data + size, onElement, onWire, onLink);
+        if (rest != data + size) ParseLine(rest, data + size, onElement, onWire, onLink);
+        stats.seconds = Elapsed();
+    }
+
+    const Stats& GetStats() const { return stats; }
+
+    // 把 [first, last) 整体解析为十进制整数（可带负号，允许前导空白），成功时才写入 value
+    static bool ParseInt(const char* first, const char* last, int& value) {
+        while (first != last && (*first == ' ' || *first == '\t')) ++first;
+        if (first == last) return false;
+#ifdef CIRCUITTEXTREADER_FROM_CHARS
+        int parsed;
+        std::from_chars_result result = std::from_chars(first, last, parsed);
+        if (result.ec != std::errc() || result.ptr != last) return false;
+        value = parsed;
+        return true;
+#else
+        // C++14 没有 std::from_chars：同样不依赖区域设置、不要求以 '\0' 结尾
+        bool negative = *first == '-';
+        if (negative && ++first == last) return false;
+        long long parsed = 0;
+        for (; first != last; ++first) {
+            unsigned digit = static_cast<unsigned>(*first - '0');
+            if (digit > 9) return false;
+            parsed = parsed * 10 + digit;
+            if (parsed > 2147483648LL) return false;
+        }
+        if (negative) parsed = -parsed;
+        if (parsed > 2147483647LL) return false;
+        value = static_cast<int>(parsed);
+        return true;
+#endif
+    }
+
+private:
+    // 处理 [first, last) 中所有以换行结尾的行，返回最后一个不完整行的开头
+    template <typename ElementHandler, typename WireHandler, typename LinkHandler>
+    const char* ParseLines(const char* first, const char* last, ElementHandler& onElement, WireHandler& onWire, LinkHandler& onLink) {
+        while (first != last) {
+            const char* newline = static_cast<const char*>(std::memchr(first, '\n', last - first));
+            if (!newline) break;
+            ParseLine(first, newline, onElement, onWire, onLink);
+            first = newline + 1;
+        }
+        return first;
+    }
+
+    template <typename ElementHandler, typename WireHandler, typename LinkHandler>
+    void ParseLine(const char* first, const char* last, ElementHandler& onElement, WireHandler& onWire, LinkHandler& onLink) {
+        ++stats.lines;
+        while (last != first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) --last;
+        if (first == last) return;
+
+        // 前四个字段的结束位置；第四个字段之后的内容不再拆分
+        const char* fieldEnd[4];
+        int fields = 0;
+        for (const char* p = first; fields < 4; ++p) {
+            p = static_cast<const char*>(std::memchr(p, ',', last - p));
+            if (!p) {
+                fieldEnd[fields++] = last;
+                break;
+            }
+            fieldEnd[fields++] = p;
+        }
+
+        const bool wire = fieldEnd[0] - first == 4 && std::memcmp(first, "WIRE", 4) == 0;
+        const bool link = fieldEnd[0] - first == 4 && std::memcmp(first, "LINK", 4) == 0;
+        if (wire || link) {
+            // 关键字之后的四个整数；第五个字段到下一个逗号或行尾为止
+            if (fields < 4 || fieldEnd[3] == last) return;
+            const char* fifth = fieldEnd[3] + 1;
+            const char* fifthEnd = static_cast<const char*>(std::memchr(fifth, ',', last - fifth));
+            int v[4];
+            if (!ParseInt(fieldEnd[0] + 1, fieldEnd[1], v[0]) || !ParseInt(fieldEnd[1] + 1, fieldEnd[2], v[1]) ||
+                !ParseInt(fieldEnd[2] + 1, fieldEnd[3], v[2]) || !ParseInt(fifth, fifthEnd ? fifthEnd : last, v[3])) {
+                return;
+            }
+            if (wire) {
+                WireLine line{ v[0], v[1], v[2], v[3] };
+                onWire(line);
+            }
+            else if (v[0] >= 0 && v[1] >= 0 && v[2] >= 0 && v[3] >= 0) {
+                LinkLine line{ static_cast<uint32_t>(v[0]), static_cast<uint32_t>(v[1]),
+                    static_cast<uint32_t>(v[2]), static_cast<uint32_t>(v[3]) };
+                onLink(line);
+            }
+            return;
+        }
+
+        ElementLine element;
+        if (!ParseInt(first, fieldEnd[0], element.type)) return;
+        element.index = elementCount++;
+        element.x = element.y = 0;
+        if (fields >= 3) {
+            ParseInt(fieldEnd[0] + 1, fieldEnd[1], element.x);
+            ParseInt(fieldEnd[1] + 1, fieldEnd[2], element.y);
+        }
+        element.line = first;
+        element.lineLength = static_cast<size_t>(last - first);
+        element.attributes = fields >= 4 ? fieldEnd[2] + 1 : last;
+        element.attributeLength = static_cast<size_t>(last - element.attributes);
+        onElement(element);
+    }
+
+    double Elapsed() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::FILE* file;
+    uint32_t elementCount;  // 已读到的元件行数
+    Stats stats;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,218 @@
+#pragma once
+#ifndef COMPILEDCIRCUIT_H
+#define COMPILEDCIRCUIT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Netlist.h"
+
+// 门操作码（与 ElementType 中 TYPE_AND..TYPE_NOR 顺序一致）
+enum GateOpcode : uint8_t {
+    GATE_AND, GATE_OR, GATE_NOT, GATE_XOR, GATE_NAND, GATE_NOR
+};
+
+// 扁平指令：out = op(in0, in1)，操作数均为线网槽位
+struct GateInstruction {
+    uint8_t opcode;
+    uint32_t in0;
+    uint32_t in1;
+    uint32_t out;
+};
+
+// 分层编译后的组合电路：按逻辑深度排序的指令流，一次线性扫描即可求值
+class CompiledCircuit {
+public:
+    CompiledCircuit() : slotCount(0), levelCount(0) {}
+
+    // 编译网表；只支持由输入、输出和逻辑门组成的无环组合电路。
+    // allowSequential 为 true 时时序元件（时钟、触发器、寄存器）的输出视为伪输入，
+    // 其下标记录在 GetSequentialElements() 中，由 SequentialCircuit 在时钟边沿更新
+    bool Compile(const Netlist& netlist, bool allowSequential = false) {
+        Reset();
+        const auto& elements = netlist.GetElements();
+        slotCount = static_cast<uint32_t>(netlist.GetNetCount());
+
+        // 记录驱动每个线网的门（-1 表示由输入元件驱动或未驱动）
+        std::vector<int> driverGate(slotCount, -1);
+        std::vector<int> gates;
+        for (size_t i = 0; i < elements.size(); ++i) {
+            const NetlistElement& element = elements[i];
+            if (element.type >= TYPE_AND && element.type <= TYPE_NOR) {
+                if (element.outputs.empty()) continue;
+                for (int net : element.outputs) driverGate[net] = static_cast<int>(i);
+                gates.push_back(static_cast<int>(i));
+            }
+            else if (element.type == TYPE_INPUT) {
+                inputSlots.push_back(element.outputs.empty() ? Netlist::CONST_ZERO_NET : element.outputs[0]);
+            }
+            else if (element.type == TYPE_OUTPUT) {
+                outputSlots.push_back(element.inputs.empty() ? Netlist::CONST_ZERO_NET : element.inputs[0]);
+            }
+            else if (allowSequential && IsSequential(element.type)) {
+                sequentialElements.push_back(static_cast<int>(i));
+            }
+            else {
+                return Fail("circuit contains sequential elements");
+            }
+        }
+
+        // 计算每个门的逻辑深度（Kahn 拓扑排序）
+        std::vector<int> gateIndex(elements.size(), -1);
+        for (size_t g = 0; g < gates.size(); ++g) gateIndex[gates[g]] = static_cast<int>(g);
+
+        std::vector<int> pending(gates.size(), 0);
+        std::vector<std::vector<int>> readers(gates.size());
+        for (size_t g = 0; g < gates.size(); ++g) {
+            for (int net : elements[gates[g]].inputs) {
+                int driver = driverGate[net];
+                if (driver < 0) continue;
+                readers[gateIndex[driver]].push_back(static_cast<int>(g));
+                pending[g]++;
+            }
+        }
+
+        std::vector<uint32_t> depth(gates.size(), 0);
+        std::vector<int> order;
+        order.reserve(gates.size());
+        for (size_t g = 0; g < gates.size(); ++g) {
+            if (pending[g] == 0) order.push_back(static_cast<int>(g));
+        }
+        for (size_t k = 0; k < order.size(); ++k) {
+            int g = order[k];
+            for (int reader : readers[g]) {
+                depth[reader] = std::max(depth[reader], depth[g] + 1);
+                if (--pending[reader] == 0) order.push_back(reader);
+            }
+        }
+        if (order.size() != gates.size()) {
+            return Fail("circuit contains a combinational loop");
+        }
+
+        // 按深度稳定排序，生成指令流
+        for (int g : order) levelCount = std::max(levelCount, depth[g] + 1);
+        std::vector<uint32_t> levelSize(levelCount + 1, 0);
+        for (int g : order) levelSize[depth[g] + 1]++;
+        levelStart.assign(levelCount + 1, 0);
+        for (uint32_t l = 0; l < levelCount; ++l) levelStart[l + 1] = levelStart[l] + levelSize[l + 1];
+
+        program.resize(gates.size());
+        std::vector<uint32_t> cursor(levelStart.begin(), levelStart.end() - 1);
+        for (size_t g = 0; g < gates.size(); ++g) {
+            const NetlistElement& element = elements[gates[g]];
+            GateInstruction instr;
+            instr.opcode = static_cast<uint8_t>(element.type - TYPE_AND);
+            instr.in0 = element.inputs.size() > 0 ? element.inputs[0] : Netlist::CONST_ZERO_NET;
+            instr.in1 = element.inputs.size() > 1 ? element.inputs[1] : instr.in0;
+            instr.out = element.outputs[0];
+            program[cursor[depth[g]]++] = instr;
+        }
+        return true;
+    }
+
+    // 单遍求值。Word 的每一位是一个独立的仿真通道：
+    // 标量仿真时用全0/全1表示逻辑值，位并行仿真时每一位对应一组输入
+    template <typename Word>
+    void Evaluate(Word* values) const {
+        values[Netlist::CONST_ZERO_NET] = 0;
+        EvaluateRange(values, 0, static_cast<uint32_t>(program.size()));
+    }
+
+    // 执行指令 [begin, end)；同一层内的区间互不依赖，可由不同线程同时执行
+    template <typename Word>
+    void EvaluateRange(Word* values, uint32_t begin, uint32_t end) const {
+        const GateInstruction* instr = program.data() + begin;
+        const GateInstruction* last = program.data() + end;
+        for (; instr != last; ++instr) {
+            Word a = values[instr->in0];
+            Word b = values[instr->in1];
+            Word r;
+            switch (instr->opcode) {
+            case GATE_AND: r = a & b; break;
+            case GATE_OR: r = a | b; break;
+            case GATE_NOT: r = ~a; break;
+            case GATE_XOR: r = a ^ b; break;
+            case GATE_NAND: r = ~(a & b); break;
+            default: r = ~(a | b); break;
+            }
+            values[instr->out] = r;
+        }
+    }
+
+    // 只保留选定输出（outputs 为输出下标）的扇入锥：从输出槽位反向标记，保留结果被读取的指令。
+    // 输入槽位不变，真值表的行与原电路一致；保留的指令维持原有的分层顺序
+    void ExtractCone(const std::vector<int>& outputs, CompiledCircuit& cone) const {
+        cone.Reset();
+        cone.slotCount = slotCount;
+        cone.inputSlots = inputSlots;
+        std::vector<bool> needed(slotCount, false);
+        for (int o : outputs) {
+            cone.outputSlots.push_back(outputSlots[o]);
+            needed[outputSlots[o]] = true;
+        }
+        std::vector<bool> keep(program.size(), false);
+        for (size_t i = program.size(); i-- > 0;) {
+            const GateInstruction& instr = program[i];
+            if (!needed[instr.out]) continue;
+            keep[i] = true;
+            needed[instr.in0] = true;
+            needed[instr.in1] = true;
+        }
+
+        // 锥中第 l 层的门至少读取一个第 l-1 层的门，所以保留的层从 0 开始连续
+        cone.levelStart.push_back(0);
+        for (uint32_t l = 0; l < levelCount; ++l) {
+            for (uint32_t i = levelStart[l]; i < levelStart[l + 1]; ++i) {
+                if (keep[i]) cone.program.push_back(program[i]);
+            }
+            if (cone.program.size() == cone.levelStart.back()) break;
+            cone.levelStart.push_back(static_cast<uint32_t>(cone.program.size()));
+        }
+        cone.levelCount = static_cast<uint32_t>(cone.levelStart.size() - 1);
+    }
+
+    bool IsValid() const { return slotCount != 0; }
+    uint32_t GetSlotCount() const { return slotCount; }
+    uint32_t GetLevelCount() const { return levelCount; }
+    const std::vector<GateInstruction>& GetProgram() const { return program; }
+    const std::vector<uint32_t>& GetLevelStart() const { return levelStart; }  // 第 l 层指令为 [levelStart[l], levelStart[l+1])
+    const std::vector<uint32_t>& GetInputSlots() const { return inputSlots; }
+    const std::vector<uint32_t>& GetOutputSlots() const { return outputSlots; }
+    const std::vector<int>& GetSequentialElements() const { return sequentialElements; }
+    const std::string& GetError() const { return error; }
+
+    static bool IsSequential(ElementType type) {
+        return type >= TYPE_CLOCK && type <= TYPE_REGISTER;
+    }
+
+private:
+    // 编译失败：清空已生成的内容并记录原因
+    bool Fail(const char* reason) {
+        Reset();
+        error = reason;
+        return false;
+    }
+
+    void Reset() {
+        program.clear();
+        levelStart.clear();
+        inputSlots.clear();
+        outputSlots.clear();
+        sequentialElements.clear();
+        error.clear();
+        slotCount = 0;
+        levelCount = 0;
+    }
+
+    std::vector<GateInstruction> program;  // 按逻辑深度排序的指令流
+    std::vector<uint32_t> levelStart;      // 每层指令的起始位置
+    std::vector<uint32_t> inputSlots;      // 输入元件驱动的槽位（按画布顺序）
+    std::vector<uint32_t> outputSlots;     // 输出元件读取的槽位（按画布顺序）
+    std::vector<int> sequentialElements;   // 时序元件在网表中的下标（仅 allowSequential 时）
+    std::string error;                     // 编译失败原因
+    uint32_t slotCount;                    // 线网槽位数量
+    uint32_t levelCount;                   // 逻辑层数
+};
+
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef COORDINATEINDEX_H
+#define COORDINATEINDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// 按坐标分桶的点索引（用于按坐标查找引脚）。点的编号为添加顺序；Find 返回容差范围内编号最小的点，
+// 与按元件顺序逐个比较引脚坐标的结果一致。桶边长大于两倍容差，每次查找最多检查 4 个桶。
+// 第一次查找时把点按桶排成连续数组并建立开放寻址的桶表，之后再添加点会在下次查找时重建
+class CoordinateIndex {
+public:
+    explicit CoordinateIndex(int tolerance) : tolerance(tolerance), built(false) {}
+
+    void Reserve(size_t count) { points.reserve(count); }
+
+    // 添加一个点，返回其编号
+    int Add(int x, int y) {
+        points.push_back(Point{ x, y });
+        built = false;
+        return static_cast<int>(points.size() - 1);
+    }
+
+    // 容差范围内编号最小的点，没有时返回 -1
+    int Find(int x, int y) const {
+        if (!built) Build();
+        if (points.empty()) return -1;
+        int best = -1;
+        for (int cx = Cell(x - tolerance); cx <= Cell(x + tolerance); ++cx) {
+            for (int cy = Cell(y - tolerance); cy <= Cell(y + tolerance); ++cy) {
+                const Bucket* bucket = FindBucket(Key(cx, cy));
+                if (!bucket) continue;
+                // 桶内按编号升序，第一个命中的就是该桶中编号最小的点
+                for (uint32_t i = bucket->begin; i < bucket->end; ++i) {
+                    const Point& p = points[order[i]];
+                    if (std::abs(p.x - x) <= tolerance && std::abs(p.y - y) <= tolerance) {
+                        if (best < 0 || static_cast<int>(order[i]) < best) best = static_cast<int>(order[i]);
+                        break;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    size_t GetSize() const { return points.size(); }
+
+private:
+    static const int CELL_SIZE = 16;
+
+    struct Point {
+        int x;
+        int y;
+    };
+
+    struct Bucket {
+        uint64_t key;
+        uint32_t begin;  // 在 order 中的范围；begin == end 表示空槽
+        uint32_t end;
+    };
+
+    static int Cell(int v) { return v >= 0 ? v / CELL_SIZE : -((-v + CELL_SIZE - 1) / CELL_SIZE); }
+    static uint64_t Key(int cx, int cy) { return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy); }
+    static size_t Hash(uint64_t key) { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32); }
+
+    void Build() const {
+        // 按 (桶, 编号) 排序后，同一桶的点连续存放且编号升序
+        std::vector<std::pair<uint64_t, uint32_t>> keyed(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            keyed[i] = std::make_pair(Key(Cell(points[i].x), Cell(points[i].y)), static_cast<uint32_t>(i));
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        size_t capacity = 16;
+        while (capacity < keyed.size() * 2) capacity *= 2;
+        buckets.assign(capacity, Bucket{ 0, 0, 0 });
+        order.resize(keyed.size());
+        for (size_t i = 0; i < keyed.size();) {
+            size_t j = i;
+            while (j < keyed.size() && keyed[j].first == keyed[i].first) {
+                order[j] = keyed[j].second;
+                ++j;
+            }
+            size_t slot = Hash(keyed[i].first) & (capacity - 1);
+            while (buckets[slot].begin != buckets[slot].end) slot = (slot + 1) & (capacity - 1);
+            buckets[slot] = Bucket{ keyed[i].first, static_cast<uint32_t>(i), static_cast<uint32_t>(j) };
+            i = j;
+        }
+        built = true;
+    }
+
+    const Bucket* FindBucket(uint64_t key) const {
+        size_t mask = buckets.size() - 1;
+        for (size_t slot = Hash(key) & mask; buckets[slot].begin != buckets[slot].end; slot = (slot + 1) & mask) {
+            if (buckets[slot].key == key) return &buckets[slot];
+        }
+        return nullptr;
+    }
+
+    int tolerance;
+    std::vector<Point> points;
+    mutable bool built;
+    mutable std::vector<uint32_t> order;
+    mutable std::vector<Bucket> buckets;
+};
+
+#endif
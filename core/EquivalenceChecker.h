@@ -0,0 +1,181 @@
+#pragma once
+#ifndef EQUIVALENCECHECKER_H
+#define EQUIVALENCECHECKER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompiledCircuit.h"
+#include "SatSolver.h"
+
+// 组合等价性检查：两个电路的输入按顺序一一相连，每对输出接一个异或门，再把所有异或的结果相或（miter）。
+// 用 Tseitin 编码把门转换成子句后交给 SAT 求解器：不可满足即等价，可满足时的赋值就是反例。
+// 两个电路中输入相同的同类门编码为同一个变量（结构哈希），结构相同的部分无需求解
+class EquivalenceChecker {
+public:
+    EquivalenceChecker() : conflictLimit(0), falseVariable(0), equivalent(false) {}
+
+    // 冲突数上限（0 为不限），超过时 Check 返回 false
+    void SetConflictLimit(uint64_t limit) { conflictLimit = limit; }
+
+    // 检查完成时返回 true，结果由 IsEquivalent / GetCounterexample 给出；
+    // 电路无法编译、输入输出数不同或求解器放弃时返回 false
+    bool Check(const Netlist& first, const Netlist& second, std::string* error = nullptr) {
+        CompiledCircuit a, b;
+        if (!a.Compile(first)) return Fail(error, "first circuit: " + a.GetError());
+        if (!b.Compile(second)) return Fail(error, "second circuit: " + b.GetError());
+        return Check(a, b, error);
+    }
+
+    bool Check(const CompiledCircuit& a, const CompiledCircuit& b, std::string* error = nullptr) {
+        equivalent = false;
+        counterexample.clear();
+        differingOutputs.clear();
+        const size_t numInputs = a.GetInputSlots().size();
+        const size_t numOutputs = a.GetOutputSlots().size();
+        if (b.GetInputSlots().size() != numInputs) {
+            return Fail(error, "circuits have different numbers of inputs (" + std::to_string(numInputs) +
+                " and " + std::to_string(b.GetInputSlots().size()) + ")");
+        }
+        if (b.GetOutputSlots().size() != numOutputs) {
+            return Fail(error, "circuits have different numbers of outputs (" + std::to_string(numOutputs) +
+                " and " + std::to_string(b.GetOutputSlots().size()) + ")");
+        }
+
+        solver = SatSolver();
+        solver.SetConflictLimit(conflictLimit);
+        gateVariables.clear();
+        falseVariable = solver.NewVariable();
+        solver.AddClause({ SatSolver::Negative(falseVariable) });
+        inputVariables.clear();
+        for (size_t i = 0; i < numInputs; ++i) inputVariables.push_back(solver.NewVariable());
+
+        std::vector<int> outputsA = Encode(a);
+        std::vector<int> outputsB = Encode(b);
+
+        // 输出对映射到同一变量时必然相等，其余每对接一个异或
+        std::vector<SatLiteral> anyDifference;
+        for (size_t o = 0; o < numOutputs; ++o) {
+            if (outputsA[o] == outputsB[o]) continue;
+            int d = solver.NewVariable();
+            AddGateClauses(GATE_XOR, d, outputsA[o], outputsB[o]);
+            anyDifference.push_back(SatSolver::Positive(d));
+        }
+        if (anyDifference.empty()) {
+            equivalent = true;
+            return true;
+        }
+        solver.AddClause(anyDifference);
+
+        SatSolver::Result result = solver.Solve();
+        if (result == SatSolver::UNKNOWN) return Fail(error, "conflict limit reached before a proof was found");
+        if (result == SatSolver::UNSAT) {
+            equivalent = true;
+            return true;
+        }
+
+        // 用反例重新求值两个电路，找出实际不同的输出
+        for (int var : inputVariables) counterexample.push_back(solver.GetModelValue(var));
+        std::vector<uint8_t> valuesA = Simulate(a), valuesB = Simulate(b);
+        for (size_t o = 0; o < numOutputs; ++o) {
+            if (valuesA[a.GetOutputSlots()[o]] != valuesB[b.GetOutputSlots()[o]]) {
+                differingOutputs.push_back(static_cast<int>(o));
+            }
+        }
+        return true;
+    }
+
+    bool IsEquivalent() const { return equivalent; }
+    // 反例：每个输入的值（Input 1 在前）；等价时为空
+    const std::vector<bool>& GetCounterexample() const { return counterexample; }
+    // 反例下取值不同的输出下标
+    const std::vector<int>& GetDifferingOutputs() const { return differingOutputs; }
+    const SatSolver& GetSolver() const { return solver; }
+
+private:
+    static bool Fail(std::string* error, const std::string& message) {
+        if (error) *error = message;
+        return false;
+    }
+
+    // 把电路的指令编码成子句，返回各输出的变量
+    std::vector<int> Encode(const CompiledCircuit& circuit) {
+        std::vector<int> slotVariable(circuit.GetSlotCount(), falseVariable);
+        const auto& inputSlots = circuit.GetInputSlots();
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            if (inputSlots[i] != Netlist::CONST_ZERO_NET) slotVariable[inputSlots[i]] = inputVariables[i];
+        }
+        for (const GateInstruction& instr : circuit.GetProgram()) {
+            int x = slotVariable[instr.in0], y = slotVariable[instr.in1];
+            if (instr.opcode != GATE_NOT && x > y) std::swap(x, y);  // 其余门都满足交换律
+            uint64_t key = (uint64_t(instr.opcode) << 58) ^ (uint64_t(x) << 29) ^ uint64_t(y);
+            auto it = gateVariables.find(key);
+            if (it != gateVariables.end()) {
+                slotVariable[instr.out] = it->second;
+                continue;
+            }
+            int out = solver.NewVariable();
+            AddGateClauses(instr.opcode, out, x, y);
+            gateVariables.emplace(key, out);
+            slotVariable[instr.out] = out;
+        }
+        std::vector<int> outputs;
+        for (uint32_t slot : circuit.GetOutputSlots()) outputs.push_back(slotVariable[slot]);
+        return outputs;
+    }
+
+    // Tseitin 编码：out <-> op(x, y)
+    void AddGateClauses(uint8_t opcode, int out, int x, int y) {
+        SatLiteral o = SatSolver::Positive(out), a = SatSolver::Positive(x), b = SatSolver::Positive(y);
+        auto n = SatSolver::Negate;
+        switch (opcode) {
+        case GATE_NAND:
+            o = n(o);
+            // fallthrough
+        case GATE_AND:
+            solver.AddClause({ n(o), a });
+            solver.AddClause({ n(o), b });
+            solver.AddClause({ o, n(a), n(b) });
+            break;
+        case GATE_NOR:
+            o = n(o);
+            // fallthrough
+        case GATE_OR:
+            solver.AddClause({ o, n(a) });
+            solver.AddClause({ o, n(b) });
+            solver.AddClause({ n(o), a, b });
+            break;
+        case GATE_NOT:
+            solver.AddClause({ o, a });
+            solver.AddClause({ n(o), n(a) });
+            break;
+        default:
+            solver.AddClause({ n(o), a, b });
+            solver.AddClause({ n(o), n(a), n(b) });
+            solver.AddClause({ o, n(a), b });
+            solver.AddClause({ o, a, n(b) });
+            break;
+        }
+    }
+
+    std::vector<uint8_t> Simulate(const CompiledCircuit& circuit) const {
+        std::vector<uint8_t> values(circuit.GetSlotCount(), 0);
+        const auto& inputSlots = circuit.GetInputSlots();
+        for (size_t i = 0; i < inputSlots.size(); ++i) {
+            if (inputSlots[i] != Netlist::CONST_ZERO_NET) values[inputSlots[i]] = counterexample[i] ? 0xFF : 0x00;
+        }
+        circuit.Evaluate(values.data());
+        return values;
+    }
+
+    uint64_t conflictLimit;
+    SatSolver solver;
+    int falseVariable;                                   // 恒为假的变量（未连接的线网）
+    std::vector<int> inputVariables;                     // 两个电路共用的输入变量
+    std::unordered_map<uint64_t, int> gateVariables;     // (操作码, 输入变量) -> 门输出变量
+    bool equivalent;
+    std::vector<bool> counterexample;
+    std::vector<int> differingOutputs;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include "FilePath.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+std::wstring FilePath::ToWide(const std::string& filename) {
+    if (filename.empty()) return std::wstring();
+    int length = MultiByteToWideChar(CP_UTF8, 0, filename.data(), static_cast<int>(filename.size()), nullptr, 0);
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, filename.data(), static_cast<int>(filename.size()), &wide[0], length);
+    return wide;
+}
+
+std::FILE* FilePath::Open(const std::string& filename, const char* mode) {
+    std::wstring wideMode(mode, mode + std::char_traits<char>::length(mode));  // 模式串只含 ASCII
+    return _wfopen(ToWide(filename).c_str(), wideMode.c_str());
+}
+
+bool FilePath::Remove(const std::string& filename) {
+    return _wremove(ToWide(filename).c_str()) == 0;
+}
+
+#else
+
+std::FILE* FilePath::Open(const std::string& filename, const char* mode) {
+    return std::fopen(filename.c_str(), mode);
+}
+
+bool FilePath::Remove(const std::string& filename) {
+    return std::remove(filename.c_str()) == 0;
+}
+
+#endif
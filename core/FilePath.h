@@ -0,0 +1,20 @@
+#pragma once
+#ifndef FILEPATH_H
+#define FILEPATH_H
+
+#include <cstdio>
+#include <string>
+
+// 核心库中的文件名一律是 UTF-8 编码的 std::string（界面用 wxString::utf8_str() 传入）。
+// Windows 的窄字符 API 按系统代码页解释路径，中文路径会打不开，所以在那里转成宽字符再调用
+class FilePath {
+public:
+    static std::FILE* Open(const std::string& filename, const char* mode);
+    static bool Remove(const std::string& filename);
+
+#ifdef _WIN32
+    static std::wstring ToWide(const std::string& filename);
+#endif
+};
+
+#endif
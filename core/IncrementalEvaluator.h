@@ -0,0 +1,86 @@
+#pragma once
+#ifndef INCREMENTALEVALUATOR_H
+#define INCREMENTALEVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "CompiledCircuit.h"
+
+// 编译电路的增量求值：已知上一次求值的全部槽位值时，只从值发生变化的槽位出发，
+// 沿读取它们的指令按层向前推进；结果不变的门不再向后传播。每条指令最多求值一次
+class IncrementalEvaluator {
+public:
+    IncrementalEvaluator() : evaluated(0) {}
+
+    // 为电路建立“槽位 -> 读取它的指令”表和指令所在的层；电路重新编译后需再次调用
+    void Prepare(const CompiledCircuit& circuit) {
+        const auto& program = circuit.GetProgram();
+        const auto& levelStart = circuit.GetLevelStart();
+        readerOffsets.assign(circuit.GetSlotCount() + 1, 0);
+        for (const GateInstruction& instr : program) {
+            readerOffsets[instr.in0 + 1]++;
+            if (instr.in1 != instr.in0) readerOffsets[instr.in1 + 1]++;
+        }
+        for (size_t s = 0; s < circuit.GetSlotCount(); ++s) readerOffsets[s + 1] += readerOffsets[s];
+        readers.assign(readerOffsets.back(), 0);
+        std::vector<uint32_t> cursor(readerOffsets.begin(), readerOffsets.end() - 1);
+        for (uint32_t i = 0; i < program.size(); ++i) {
+            readers[cursor[program[i].in0]++] = i;
+            if (program[i].in1 != program[i].in0) readers[cursor[program[i].in1]++] = i;
+        }
+
+        level.assign(program.size(), 0);
+        for (uint32_t l = 0; l < circuit.GetLevelCount(); ++l) {
+            for (uint32_t i = levelStart[l]; i < levelStart[l + 1]; ++i) level[i] = l;
+        }
+        buckets.assign(circuit.GetLevelCount(), std::vector<uint32_t>());
+        queued.assign(program.size(), false);
+    }
+
+    // changed 中的槽位已写入新值；推进到不动点，并把值发生变化的门输出槽位追加到 changed 之后
+    template <typename Word>
+    void Propagate(const CompiledCircuit& circuit, Word* values, std::vector<uint32_t>& changed) {
+        evaluated = 0;
+        uint32_t lowest = static_cast<uint32_t>(buckets.size()), highest = 0;
+        auto scheduleReaders = [&](uint32_t slot) {
+            for (uint32_t k = readerOffsets[slot]; k < readerOffsets[slot + 1]; ++k) {
+                uint32_t i = readers[k];
+                if (queued[i]) continue;
+                queued[i] = true;
+                buckets[level[i]].push_back(i);
+                lowest = std::min(lowest, level[i]);
+                highest = std::max(highest, level[i]);
+            }
+        };
+        for (uint32_t slot : changed) scheduleReaders(slot);
+
+        // 读取者总在更高的层，按层递增处理即可保证每条指令的输入都已是最终值
+        const auto& program = circuit.GetProgram();
+        for (uint32_t l = lowest; l <= highest && l < buckets.size(); ++l) {
+            for (size_t k = 0; k < buckets[l].size(); ++k) {
+                uint32_t i = buckets[l][k];
+                queued[i] = false;
+                evaluated++;
+                Word old = values[program[i].out];
+                circuit.EvaluateRange(values, i, i + 1);
+                if (values[program[i].out] == old) continue;
+                changed.push_back(program[i].out);
+                scheduleReaders(program[i].out);
+            }
+            buckets[l].clear();
+        }
+    }
+
+    // 最近一次 Propagate 求值的指令数
+    size_t GetEvaluatedCount() const { return evaluated; }
+
+private:
+    std::vector<uint32_t> readerOffsets;         // 槽位 -> readers 中的区间（CSR）
+    std::vector<uint32_t> readers;               // 读取各槽位的指令
+    std::vector<uint32_t> level;                 // 指令所在的层
+    std::vector<std::vector<uint32_t>> buckets;  // 每层待求值的指令
+    std::vector<bool> queued;
+    size_t evaluated;
+};
+
+#endif
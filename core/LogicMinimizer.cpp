@@ -0,0 +1,374 @@
+#include "LogicMinimizer.h"
+
+#include <algorithm>
+#include <bitset>
+#include <climits>
+#include <map>
+
+namespace {
+
+    // 约简-扩展-去冗余循环的最大轮数
+    const int MAX_PASSES = 8;
+
+    // 扩展时为候选变量计分（统计新覆盖的未覆盖最小项）的自由变量数上限
+    const int MAX_SCORED_FREE = 10;
+
+    // 综合布局：列距和行距（画布坐标）
+    const int COLUMN_SPACING = 140;
+    const int ROW_SPACING = 80;
+
+    int PopCount(uint32_t x) {
+        return static_cast<int>(std::bitset<32>(x).count());
+    }
+
+    int CeilLog2(size_t x) {
+        int bits = 0;
+        while ((size_t(1) << bits) < x) bits++;
+        return bits;
+    }
+
+    // 行号第 var 位为 0 的位模式（var < 6）
+    const uint64_t LOW_HALF[6] = {
+        0x5555555555555555ull, 0x3333333333333333ull, 0x0F0F0F0F0F0F0F0Full,
+        0x00FF00FF00FF00FFull, 0x0000FFFF0000FFFFull, 0x00000000FFFFFFFFull
+    };
+
+    // bits 与自身沿第 var 位的镜像求与：结果第 r 行为 1 当且仅当 r 和 r ^ (1 << var) 原来都为 1
+    void MirrorAnd(std::vector<uint64_t>& bits, int var) {
+        if (var < 6) {
+            int shift = 1 << var;
+            uint64_t low = LOW_HALF[var];
+            for (uint64_t& word : bits) {
+                word &= ((word & low) << shift) | ((word >> shift) & low);
+            }
+            return;
+        }
+        size_t stride = size_t(1) << (var - 6);
+        for (size_t k = 0; k < bits.size(); ++k) {
+            if (k & stride) continue;
+            uint64_t both = bits[k] & bits[k | stride];
+            bits[k] = both;
+            bits[k | stride] = both;
+        }
+    }
+
+    bool TestBit(const std::vector<uint64_t>& bits, uint32_t row) {
+        return ((bits[row >> 6] >> (row & 63)) & 1) != 0;
+    }
+
+    // 依次访问乘积项包含的每个最小项
+    template <typename Fn>
+    void ForEachMinterm(const Cube& cube, uint32_t full, Fn fn) {
+        uint32_t freeBits = ~cube.mask & full;
+        uint32_t sub = 0;
+        do {
+            fn(cube.value | sub);
+            sub = (sub - freeBits) & freeBits;
+        } while (sub != 0);
+    }
+
+    // 单个输出的最小化过程。count[m] 记录覆盖最小项 m 的乘积项数
+    class Minimizer {
+    public:
+        Minimizer(const uint64_t* bits, int numInputs)
+            : n(numInputs), full(numInputs >= 32 ? ~0u : (1u << numInputs) - 1),
+            rows(size_t(1) << numInputs), count(rows, 0) {
+            size_t words = std::max<size_t>(1, rows / 64);
+            on.assign(bits, bits + words);
+            if (rows < 64) on[0] &= (uint64_t(1) << rows) - 1;
+        }
+
+        void Run(std::vector<Cube>& result) {
+            // 初始覆盖：相邻最小项少的（更难合并的）先扩展，其质蕴涵项更可能是必要的
+            std::vector<std::vector<uint32_t>> seeds(n + 1);
+            for (uint32_t m = 0; m < rows; ++m) {
+                if (!TestBit(on, m)) continue;
+                int neighbors = 0;
+                for (int v = 0; v < n; ++v) neighbors += TestBit(on, m ^ (1u << v)) ? 1 : 0;
+                seeds[neighbors].push_back(m);
+            }
+            cover.clear();
+            for (const auto& bucket : seeds) {
+                for (uint32_t m : bucket) {
+                    if (count[m] != 0) continue;
+                    Cube cube = Expand(Cube{ full, m }, 0);
+                    Add(cube);
+                    cover.push_back(cube);
+                }
+            }
+            Irredundant();
+
+            // 约简-扩展-去冗余，每轮换一个变量起点，直到代价不再下降
+            std::vector<Cube> best = cover;
+            for (int pass = 1; pass <= MAX_PASSES; ++pass) {
+                ReduceExpand(pass % std::max(n, 1));
+                Irredundant();
+                if (!Better(cover, best)) break;
+                best = cover;
+            }
+            result.swap(best);
+        }
+
+    private:
+        // 把乘积项扩展为质蕴涵项：每次去掉一个文字，优先选择新覆盖未覆盖最小项最多的。
+        // 自由变量少时直接检查翻转的一半是否都在开集中；多时改用位集 I_S（S 为当前的自由变量），
+        // 每个候选只需查一位
+        Cube Expand(Cube cube, int rotation) {
+            std::vector<uint64_t> implicant;
+            int freeCount = PopCount(~cube.mask & full);
+            auto feasible = [&](uint32_t flipped) {
+                if (!implicant.empty()) return TestBit(implicant, flipped);
+                bool all = true;
+                ForEachMinterm(Cube{ cube.mask, flipped }, full, [this, &all](uint32_t m) {
+                    if (!TestBit(on, m)) all = false;
+                });
+                return all;
+            };
+
+            for (;;) {
+                if (implicant.empty() && (size_t(1) << freeCount) * 4 > on.size()) {
+                    implicant = on;
+                    for (int v = 0; v < n; ++v) {
+                        if (!(cube.mask & (1u << v))) MirrorAnd(implicant, v);
+                    }
+                }
+                int best = -1;
+                long bestScore = -1;
+                for (int k = 0; k < n; ++k) {
+                    int v = (k + rotation) % n;
+                    uint32_t bit = 1u << v;
+                    if (!(cube.mask & bit) || !feasible(cube.value ^ bit)) continue;
+                    long score = 0;
+                    if (freeCount <= MAX_SCORED_FREE) {
+                        ForEachMinterm(Cube{ cube.mask, cube.value ^ bit }, full, [this, &score](uint32_t m) {
+                            if (count[m] == 0) score++;
+                        });
+                    }
+                    if (score > bestScore) {
+                        best = v;
+                        bestScore = score;
+                    }
+                }
+                if (best < 0) return cube;
+                cube.mask &= ~(1u << best);
+                cube.value &= ~(1u << best);
+                if (!implicant.empty()) MirrorAnd(implicant, best);
+                freeCount++;
+            }
+        }
+
+        void Add(const Cube& cube) {
+            ForEachMinterm(cube, full, [this](uint32_t m) { count[m]++; });
+        }
+
+        void Remove(const Cube& cube) {
+            ForEachMinterm(cube, full, [this](uint32_t m) { count[m]--; });
+        }
+
+        // 去掉所有最小项都被其他乘积项覆盖的乘积项，文字多（覆盖小）的先去
+        void Irredundant() {
+            std::vector<size_t> order(cover.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+                return PopCount(cover[a].mask) > PopCount(cover[b].mask);
+            });
+            std::vector<bool> removed(cover.size(), false);
+            for (size_t i : order) {
+                bool redundant = true;
+                ForEachMinterm(cover[i], full, [this, &redundant](uint32_t m) {
+                    if (count[m] < 2) redundant = false;
+                });
+                if (!redundant) continue;
+                Remove(cover[i]);
+                removed[i] = true;
+            }
+            Compact(removed);
+        }
+
+        // 依次把每个乘积项约简为只覆盖它独有最小项的最小乘积项，再按新的变量顺序扩展
+        void ReduceExpand(int rotation) {
+            std::vector<size_t> order(cover.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+                return PopCount(cover[a].mask) < PopCount(cover[b].mask);
+            });
+            std::vector<bool> removed(cover.size(), false);
+            for (size_t i : order) {
+                Remove(cover[i]);
+                uint32_t andAll = full, orAll = 0;
+                bool any = false;
+                ForEachMinterm(cover[i], full, [&](uint32_t m) {
+                    if (count[m] != 0) return;
+                    andAll &= m;
+                    orAll |= m;
+                    any = true;
+                });
+                if (!any) {
+                    removed[i] = true;
+                    continue;
+                }
+                uint32_t mask = ~(andAll ^ orAll) & full;
+                cover[i] = Expand(Cube{ mask, andAll & mask }, rotation);
+                Add(cover[i]);
+            }
+            Compact(removed);
+        }
+
+        void Compact(const std::vector<bool>& removed) {
+            size_t kept = 0;
+            for (size_t i = 0; i < cover.size(); ++i) {
+                if (!removed[i]) cover[kept++] = cover[i];
+            }
+            cover.resize(kept);
+        }
+
+        // 乘积项少者更优，相同时文字少者更优
+        static bool Better(const std::vector<Cube>& a, const std::vector<Cube>& b) {
+            if (a.size() != b.size()) return a.size() < b.size();
+            return LogicMinimizer::CountLiterals(a) < LogicMinimizer::CountLiterals(b);
+        }
+
+        int n;
+        uint32_t full;                   // 全部变量的掩码
+        uint32_t rows;
+        std::vector<uint64_t> on;        // 开集
+        std::vector<uint32_t> count;     // 每个最小项被覆盖的次数
+        std::vector<Cube> cover;
+    };
+
+}
+
+bool LogicMinimizer::Minimize(const TruthTableData& table, int output, std::vector<Cube>& cover) {
+    if (table.numInputs > MAX_INPUTS || output < 0 || output >= table.numOutputs) return false;
+    Minimize(table.bits.data() + output * table.wordsPerOutput, table.numInputs, cover);
+    return true;
+}
+
+void LogicMinimizer::Minimize(const uint64_t* bits, int numInputs, std::vector<Cube>& cover) {
+    Minimizer minimizer(bits, numInputs);
+    minimizer.Run(cover);
+}
+
+size_t LogicMinimizer::CountLiterals(const std::vector<Cube>& cover) {
+    size_t literals = 0;
+    for (const Cube& cube : cover) literals += PopCount(cube.mask);
+    return literals;
+}
+
+std::string LogicMinimizer::Format(const std::vector<Cube>& cover, int numInputs) {
+    if (cover.empty()) return "0";
+    std::string text;
+    for (const Cube& cube : cover) {
+        if (cube.mask == 0) return "1";
+        if (!text.empty()) text += " | ";
+        bool first = true;
+        for (int input = 0; input < numInputs; ++input) {
+            uint32_t bit = 1u << (numInputs - 1 - input);
+            if (!(cube.mask & bit)) continue;
+            if (!first) text += " & ";
+            first = false;
+            text += (cube.value & bit) ? "I" : "!I";
+            text += std::to_string(input + 1);
+        }
+    }
+    return text;
+}
+
+void LogicMinimizer::Synthesize(const Netlist& original, const std::vector<std::vector<Cube>>& covers,
+    Netlist& result) {
+    result.Clear();
+    const auto& elements = original.GetElements();
+
+    // 保留输入元件，确定门区域的位置
+    std::vector<int> inputNets;
+    std::vector<const NetlistElement*> outputs;
+    int maxX = INT_MIN, minY = INT_MAX;
+    for (const NetlistElement& element : elements) {
+        if (element.type == TYPE_INPUT) {
+            int index = result.AddElement(TYPE_INPUT, element.value, element.x, element.y);
+            int net = result.AddNet();
+            result.GetElements()[index].outputs.push_back(net);
+            result.GetElements()[index].attributes = element.attributes;
+            inputNets.push_back(net);
+            maxX = std::max(maxX, element.x);
+            minY = std::min(minY, element.y);
+        }
+        else if (element.type == TYPE_OUTPUT) {
+            outputs.push_back(&element);
+            minY = std::min(minY, element.y);
+        }
+    }
+    if (maxX == INT_MIN) maxX = 0;
+    if (minY == INT_MAX) minY = 0;
+    const int numInputs = static_cast<int>(inputNets.size());
+
+    // 列：非门、与门树各层、或门树各层、输出
+    int andDepth = 0, orDepth = 0;
+    for (const auto& cover : covers) {
+        orDepth = std::max(orDepth, CeilLog2(cover.size()));
+        for (const Cube& cube : cover) andDepth = std::max(andDepth, CeilLog2(PopCount(cube.mask)));
+    }
+    const int notX = maxX + COLUMN_SPACING;
+    auto andX = [&](int level) { return notX + COLUMN_SPACING * level; };
+    auto orX = [&](int level) { return notX + COLUMN_SPACING * (andDepth + level); };
+    const int outputX = notX + COLUMN_SPACING * (andDepth + orDepth + 1);
+
+    std::map<int, int> nextRow;  // 每列已放置的门数
+    auto addGate = [&](ElementType type, int x, int a, int b) {
+        int y = minY + ROW_SPACING * nextRow[x]++;
+        int index = result.AddElement(type, false, x, y);
+        int net = result.AddNet();
+        NetlistElement& gate = result.GetElements()[index];
+        gate.inputs.push_back(a);
+        if (type != TYPE_NOT) gate.inputs.push_back(b);
+        gate.outputs.push_back(net);
+        return net;
+    };
+    // 两输入门组成的平衡树
+    auto addTree = [&](ElementType type, std::vector<int> nets, bool orTree) {
+        for (int level = 1; nets.size() > 1; ++level) {
+            std::vector<int> next;
+            for (size_t i = 0; i < nets.size(); i += 2) {
+                if (i + 1 < nets.size()) next.push_back(addGate(type, orTree ? orX(level) : andX(level), nets[i], nets[i + 1]));
+                else next.push_back(nets[i]);
+            }
+            nets.swap(next);
+        }
+        return nets[0];
+    };
+
+    std::vector<int> invertedNets(numInputs, -1);
+    for (size_t o = 0; o < outputs.size(); ++o) {
+        static const std::vector<Cube> empty;
+        const std::vector<Cube>& cover = o < covers.size() ? covers[o] : empty;
+        bool tautology = std::any_of(cover.begin(), cover.end(), [](const Cube& cube) { return cube.mask == 0; });
+
+        int net = Netlist::CONST_ZERO_NET;  // 空覆盖：输出不连接，恒为 0
+        if (tautology) {
+            net = addGate(TYPE_NOT, notX, Netlist::CONST_ZERO_NET, 0);  // 未连接的非门输出恒为 1
+        }
+        else if (!cover.empty()) {
+            std::vector<int> terms;
+            for (const Cube& cube : cover) {
+                std::vector<int> literals;
+                for (int input = 0; input < numInputs; ++input) {
+                    uint32_t bit = 1u << (numInputs - 1 - input);
+                    if (!(cube.mask & bit)) continue;
+                    if (cube.value & bit) {
+                        literals.push_back(inputNets[input]);
+                        continue;
+                    }
+                    if (invertedNets[input] < 0) invertedNets[input] = addGate(TYPE_NOT, notX, inputNets[input], 0);
+                    literals.push_back(invertedNets[input]);
+                }
+                terms.push_back(addTree(TYPE_AND, literals, false));
+            }
+            net = addTree(TYPE_OR, terms, true);
+        }
+
+        const NetlistElement& output = *outputs[o];
+        int index = result.AddElement(TYPE_OUTPUT, output.value, outputX, output.y);
+        result.GetElements()[index].inputs.push_back(net);
+        result.GetElements()[index].attributes = output.attributes;
+    }
+}
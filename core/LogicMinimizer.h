@@ -0,0 +1,45 @@
+#pragma once
+#ifndef LOGICMINIMIZER_H
+#define LOGICMINIMIZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Netlist.h"
+#include "TruthTable.h"
+
+// 乘积项：mask 中为 1 的位是出现的文字，value 给出这些文字的取值。
+// 位 b 对应真值表行号的第 b 位，即第 numInputs-1-b 个输入（Input 1 为最高位）
+struct Cube {
+    uint32_t mask;
+    uint32_t value;
+
+    bool Contains(uint32_t minterm) const { return (minterm & mask) == value; }
+};
+
+// 两级逻辑最小化（Espresso 风格的启发式）：先把每个最小项扩展为质蕴涵项得到初始覆盖，
+// 再反复进行约简（reduce）、扩展（expand）和去冗余（irredundant），直到乘积项和文字数不再减少。
+// 大乘积项的蕴涵项判断用位集完成：I_S 标记所有"在变量集 S 上任意取值都为 1"的行，扩展一个变量只需查一位
+class LogicMinimizer {
+public:
+    enum : int { MAX_INPUTS = 20 };
+
+    // 最小化真值表的第 output 个输出；输入数超过 MAX_INPUTS 时返回 false
+    static bool Minimize(const TruthTableData& table, int output, std::vector<Cube>& cover);
+
+    // bits 为 2^numInputs 位的开集（第 r 行的值为 bits[r >> 6] 的第 r & 63 位）
+    static void Minimize(const uint64_t* bits, int numInputs, std::vector<Cube>& cover);
+
+    // 覆盖的文字总数
+    static size_t CountLiterals(const std::vector<Cube>& cover);
+
+    // 写成与或表达式，例如 "I1 & !I3 | I2"；空覆盖为 "0"，恒真为 "1"
+    static std::string Format(const std::vector<Cube>& cover, int numInputs);
+
+    // 用与或两级门电路实现各输出的覆盖：保留 original 中的输入输出元件（顺序、值和名称），
+    // 丢弃其余元件，门放在输入右侧按层排列。covers[o] 对应第 o 个输出元件
+    static void Synthesize(const Netlist& original, const std::vector<std::vector<Cube>>& covers,
+        Netlist& result);
+};
+
+#endif
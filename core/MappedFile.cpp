@@ -0,0 +1,72 @@
+#include "MappedFile.h"
+
+#include "FilePath.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const std::string& filename, std::string* error) {
+    Close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(FilePath::ToWide(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return Fail(error, "cannot open " + filename);
+    file = handle;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(handle, &length)) return Fail(error, "cannot read " + filename);
+    size = static_cast<size_t>(length.QuadPart);
+    if (size == 0) return true;  // 空文件无法映射
+    mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return Fail(error, "cannot map " + filename);
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) return Fail(error, "cannot map " + filename);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return Fail(error, "cannot open " + filename);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return Fail(error, "cannot read " + filename);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            data = static_cast<const char*>(view);
+            ::madvise(view, size, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);  // 关闭文件后映射仍然有效
+    if (size > 0 && !data) return Fail(error, "cannot map " + filename);
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(static_cast<HANDLE>(mapping));
+    if (file) CloseHandle(static_cast<HANDLE>(file));
+#else
+    if (data) ::munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+    file = nullptr;
+    mapping = nullptr;
+}
+
+bool MappedFile::Fail(std::string* error, const std::string& message) {
+    Close();
+    if (error) *error = message;
+    return false;
+}
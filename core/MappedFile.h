@@ -0,0 +1,33 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// 只读内存映射文件：内容按需由操作系统分页读入，不复制到进程的缓冲区。
+// 平台相关的句柄只在 MappedFile.cpp 中使用，头文件不引入系统头文件
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0), file(nullptr), mapping(nullptr) {}
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename, std::string* error = nullptr);
+    void Close();
+
+    const char* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+private:
+    bool Fail(std::string* error, const std::string& message);
+
+    const char* data;
+    size_t size;
+    void* file;     // Windows 的文件句柄
+    void* mapping;  // Windows 的映射对象
+};
+
+#endif
@@ -0,0 +1,286 @@
+#include "ModelExporter.h"
+
+#include <cctype>
+#include "FilePath.h"
+#include "SequentialCircuit.h"
+
+namespace {
+
+    std::string Net(uint32_t net) {
+        return "n[" + std::to_string(net) + "]";
+    }
+
+    std::string State(int word) {
+        return "state[" + std::to_string(word) + "]";
+    }
+
+    // 数组长度至少为 1，避免零长度数组
+    std::string ArraySize(const char* name) {
+        return std::string("(") + name + " > 0 ? " + name + " : 1)";
+    }
+
+    // 每类时序元件占用的状态字数
+    int StateWords(ElementType type) {
+        switch (type) {
+        case TYPE_RS_FLIPFLOP: return 2;
+        case TYPE_REGISTER: return 4;
+        default: return 1;
+        }
+    }
+
+    bool WriteFile(const std::string& filename, const std::string& text, std::string* error) {
+        std::FILE* file = FilePath::Open(filename, "wb");
+        bool ok = file && std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        if (file && std::fclose(file) != 0) ok = false;
+        if (!ok && error) *error = "cannot write " + filename;
+        return ok;
+    }
+
+}
+
+std::string ModelExporter::SanitizeIdentifier(const std::string& name) {
+    std::string id;
+    for (char c : name) id += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    if (id.empty() || std::isdigit(static_cast<unsigned char>(id[0]))) id = "Model_" + id;
+    return id;
+}
+
+bool ModelExporter::Generate(const Netlist& netlist, const std::string& className, ModelSource& model,
+    std::string* error) {
+    SequentialCircuit circuit;
+    if (!circuit.Compile(netlist)) {
+        if (error) *error = circuit.GetError();
+        return false;
+    }
+    const CompiledCircuit& logic = circuit.GetCombinational();
+    const auto& elements = netlist.GetElements();
+    const std::string name = SanitizeIdentifier(className);
+
+    // 为时序元件分配状态字、时钟计数器和边沿检测字
+    struct StateLayout {
+        int element;
+        int word;       // 第一个状态字
+        int clock;      // 时钟分频计数器下标（仅时钟）
+        int lastClock;  // 边沿检测字下标（仅边沿触发元件）
+    };
+    std::vector<StateLayout> layout;
+    int stateWords = 0, clockCount = 0, edgeCount = 0;
+    for (int index : logic.GetSequentialElements()) {
+        ElementType type = elements[index].type;
+        StateLayout entry{ index, stateWords, -1, -1 };
+        stateWords += StateWords(type);
+        if (type == TYPE_CLOCK) entry.clock = clockCount++;
+        else if (type != TYPE_RS_FLIPFLOP) entry.lastClock = edgeCount++;
+        layout.push_back(entry);
+    }
+
+    const size_t numInputs = logic.GetInputSlots().size();
+    const size_t numOutputs = logic.GetOutputSlots().size();
+
+    // 头文件
+    std::string& h = model.header;
+    h = "// " + name + ": C++ simulation model exported from a circuit. Generated file, do not edit.\n"
+        "#pragma once\n"
+        "#include <cstdint>\n\n"
+        "struct " + name + " {\n"
+        "    typedef uint64_t word;  // each bit is an independent simulation lane; use 0 / ~0 for a single lane\n\n"
+        "    enum {\n"
+        "        NUM_INPUTS = " + std::to_string(numInputs) + ",\n"
+        "        NUM_OUTPUTS = " + std::to_string(numOutputs) + ",\n"
+        "        NUM_STATE = " + std::to_string(stateWords) + ",\n"
+        "        NUM_CLOCKS = " + std::to_string(clockCount) + ",\n"
+        "        NUM_EDGES = " + std::to_string(edgeCount) + ",\n"
+        "        NUM_NETS = " + std::to_string(logic.GetSlotCount()) + "\n"
+        "    };\n\n"
+        "    word inputs[" + ArraySize("NUM_INPUTS") + "];        // input elements, in circuit order\n"
+        "    word outputs[" + ArraySize("NUM_OUTPUTS") + "];      // output elements, in circuit order\n"
+        "    word state[" + ArraySize("NUM_STATE") + "];          // clock levels and flip-flop / register bits\n"
+        "    word lastClock[" + ArraySize("NUM_EDGES") + "];      // clock level seen by each edge-triggered element\n"
+        "    int counters[" + ArraySize("NUM_CLOCKS") + "];       // clock dividers (toggle every `frequency` steps)\n"
+        "    word nets[NUM_NETS];\n\n"
+        "    " + name + "();\n"
+        "    void reset();  // restore the initial state and settle the logic (inputs are kept)\n"
+        "    void eval();   // settle the combinational logic from the inputs and the current state\n"
+        "    void step();   // one clock step: advance clocks, sample all state elements, commit, settle\n"
+        "};\n";
+
+    // 源文件
+    std::string& s = model.source;
+    s = "// " + name + ": generated file, do not edit.\n"
+        "#include \"" + name + ".h\"\n\n";
+
+    s += name + "::" + name + "() {\n";
+    size_t input = 0;
+    for (const NetlistElement& element : elements) {
+        if (element.type != TYPE_INPUT) continue;
+        s += "    inputs[" + std::to_string(input++) + "] = " + (element.value ? "~word(0)" : "0") + ";\n";
+    }
+    s += "    reset();\n}\n\n";
+
+    s += "void " + name + "::reset() {\n";
+    for (const StateLayout& entry : layout) {
+        uint32_t bits = circuit.GetState(entry.element);
+        ElementType type = elements[entry.element].type;
+        int words = StateWords(type);
+        if (type == TYPE_CLOCK) bits &= 1u;
+        for (int k = 0; k < words; ++k) {
+            s += "    " + State(entry.word + k) + " = " + (((bits >> k) & 1u) ? "~word(0)" : "0") + ";\n";
+        }
+        if (entry.clock >= 0) s += "    counters[" + std::to_string(entry.clock) + "] = 0;\n";
+    }
+    s += "    eval();\n";
+    for (const StateLayout& entry : layout) {
+        if (entry.lastClock < 0) continue;
+        const NetlistElement& element = elements[entry.element];
+        size_t port = element.type == TYPE_D_FLIPFLOP || element.type == TYPE_T_FLIPFLOP ? 1 :
+            element.type == TYPE_JK_FLIPFLOP ? 2 : 4;
+        uint32_t net = port < element.inputs.size() ? element.inputs[port] : Netlist::CONST_ZERO_NET;
+        s += "    lastClock[" + std::to_string(entry.lastClock) + "] = nets[" + std::to_string(net) + "];\n";
+    }
+    s += "}\n\n";
+
+    // eval：输入和状态写入线网，按逻辑深度展开所有门
+    s += "void " + name + "::eval() {\n"
+        "    word* n = nets;\n"
+        "    " + Net(Netlist::CONST_ZERO_NET) + " = 0;\n";
+    for (size_t i = 0; i < numInputs; ++i) {
+        s += "    " + Net(logic.GetInputSlots()[i]) + " = inputs[" + std::to_string(i) + "];\n";
+    }
+    for (const StateLayout& entry : layout) {
+        const NetlistElement& element = elements[entry.element];
+        for (size_t k = 0; k < element.outputs.size(); ++k) {
+            std::string value;
+            switch (element.type) {
+            case TYPE_D_FLIPFLOP:
+            case TYPE_JK_FLIPFLOP:
+            case TYPE_T_FLIPFLOP:
+                value = k == 0 ? State(entry.word) : "~" + State(entry.word);  // Q, Q'
+                break;
+            default:
+                value = State(entry.word + static_cast<int>(k));
+                break;
+            }
+            s += "    " + Net(element.outputs[k]) + " = " + value + ";\n";
+        }
+    }
+    for (const GateInstruction& instr : logic.GetProgram()) {
+        std::string a = Net(instr.in0), b = Net(instr.in1), expr;
+        switch (instr.opcode) {
+        case GATE_AND: expr = a + " & " + b; break;
+        case GATE_OR: expr = a + " | " + b; break;
+        case GATE_NOT: expr = "~" + a; break;
+        case GATE_XOR: expr = a + " ^ " + b; break;
+        case GATE_NAND: expr = "~(" + a + " & " + b + ")"; break;
+        default: expr = "~(" + a + " | " + b + ")"; break;
+        }
+        s += "    " + Net(instr.out) + " = " + expr + ";\n";
+    }
+    for (size_t o = 0; o < numOutputs; ++o) {
+        s += "    outputs[" + std::to_string(o) + "] = " + Net(logic.GetOutputSlots()[o]) + ";\n";
+    }
+    s += "}\n\n";
+
+    // step：与 SequentialCircuit::Step 相同的两阶段语义
+    s += "void " + name + "::step() {\n";
+    if (clockCount < static_cast<int>(layout.size())) s += "    word* n = nets;\n";
+    for (const StateLayout& entry : layout) {
+        if (entry.clock < 0 || !circuit.IsClockEnabled(entry.element)) continue;
+        std::string counter = "counters[" + std::to_string(entry.clock) + "]";
+        s += "    if (++" + counter + " >= " + std::to_string(circuit.GetClockFrequency(entry.element)) + ") {\n"
+            "        " + counter + " = 0;\n"
+            "        " + State(entry.word) + " = ~" + State(entry.word) + ";\n"
+            "    }\n";
+    }
+    s += "    eval();\n";
+
+    // 所有元件先根据同一组线网值计算新状态，再统一提交
+    std::string commit;
+    for (const StateLayout& entry : layout) {
+        const NetlistElement& element = elements[entry.element];
+        if (element.type == TYPE_CLOCK) continue;
+        auto in = [&](size_t port) {
+            return Net(port < element.inputs.size() ? element.inputs[port] : Netlist::CONST_ZERO_NET);
+        };
+        std::string id = std::to_string(entry.word);
+        std::string q = State(entry.word);
+        if (element.type == TYPE_RS_FLIPFLOP) {
+            std::string qn = State(entry.word + 1);
+            s += "    word next" + id + " = " + in(0) + " | (~" + in(1) + " & " + q + ");\n"
+                "    word next" + std::to_string(entry.word + 1) + " = " + in(1) + " | (~" + in(0) + " & " + qn + ");\n";
+            commit += "    " + q + " = next" + id + ";\n"
+                "    " + qn + " = next" + std::to_string(entry.word + 1) + ";\n";
+            continue;
+        }
+
+        std::string last = "lastClock[" + std::to_string(entry.lastClock) + "]";
+        std::string clock = element.type == TYPE_D_FLIPFLOP || element.type == TYPE_T_FLIPFLOP ? in(1) :
+            element.type == TYPE_JK_FLIPFLOP ? in(2) : in(4);
+        std::string edge = "edge" + id;
+        s += "    word " + edge + " = " + clock + " & ~" + last + ";\n"
+            "    " + last + " = " + clock + ";\n";
+        switch (element.type) {
+        case TYPE_D_FLIPFLOP:
+            s += "    word next" + id + " = (" + edge + " & " + in(0) + ") | (~" + edge + " & " + q + ");\n";
+            break;
+        case TYPE_JK_FLIPFLOP:
+            s += "    word next" + id + " = (" + edge + " & ((" + in(0) + " & ~" + q + ") | (~" + in(1) + " & " + q +
+                "))) | (~" + edge + " & " + q + ");\n";
+            break;
+        case TYPE_T_FLIPFLOP:
+            s += "    word next" + id + " = " + q + " ^ (" + edge + " & " + in(0) + ");\n";
+            break;
+        default: {  // 寄存器：LOAD 为高时在上升沿加载 D0-D3
+            std::string load = "load" + id;
+            s += "    word " + load + " = " + edge + " & " + in(5) + ";\n";
+            for (int k = 0; k < 4; ++k) {
+                std::string bit = std::to_string(entry.word + k);
+                s += "    word next" + bit + " = (" + load + " & " + in(k) + ") | (~" + load + " & " + State(entry.word + k) + ");\n";
+                if (k > 0) commit += "    " + State(entry.word + k) + " = next" + bit + ";\n";
+            }
+            break;
+        }
+        }
+        commit += "    " + q + " = next" + id + ";\n";
+    }
+    s += commit;
+    s += "    eval();\n}\n";
+
+    // 驱动程序
+    model.driver = "// " + name + " driver: generated file.\n"
+        "// usage: " + name + " [steps] [input bits, e.g. 0110 with input 0 first]\n"
+        "#include <chrono>\n"
+        "#include <cstdio>\n"
+        "#include <cstdlib>\n"
+        "#include \"" + name + ".h\"\n\n"
+        "int main(int argc, char** argv) {\n"
+        "    static " + name + " model;\n"
+        "    long long steps = argc > 1 ? std::atoll(argv[1]) : 0;\n"
+        "    if (argc > 2) {\n"
+        "        for (int i = 0; i < " + name + "::NUM_INPUTS && argv[2][i]; ++i) {\n"
+        "            model.inputs[i] = argv[2][i] == '1' ? ~" + name + "::word(0) : 0;\n"
+        "        }\n"
+        "    }\n"
+        "    model.reset();\n\n"
+        "    auto start = std::chrono::steady_clock::now();\n"
+        "    for (long long i = 0; i < steps; ++i) model.step();\n"
+        "    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();\n\n"
+        "    for (int o = 0; o < " + name + "::NUM_OUTPUTS; ++o) std::putchar((model.outputs[o] & 1) ? '1' : '0');\n"
+        "    std::putchar('\\n');\n"
+        "    if (steps > 0 && seconds > 0) {\n"
+        "        std::fprintf(stderr, \"%lld steps, %.3f s, %.2f M steps/s\\n\", steps, seconds, steps / seconds / 1e6);\n"
+        "    }\n"
+        "    return 0;\n"
+        "}\n";
+    return true;
+}
+
+bool ModelExporter::Write(const Netlist& netlist, const std::string& directory, const std::string& className,
+    std::string* error) {
+    ModelSource model;
+    if (!Generate(netlist, className, model, error)) return false;
+    std::string name = SanitizeIdentifier(className);
+    std::string prefix = directory.empty() ? name : directory + "/" + name;
+    return WriteFile(prefix + ".h", model.header, error) &&
+        WriteFile(prefix + ".cpp", model.source, error) &&
+        WriteFile(prefix + "_main.cpp", model.driver, error);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef MODELEXPORTER_H
+#define MODELEXPORTER_H
+
+#include <string>
+#include "Netlist.h"
+
+// 生成的 C++ 模型源码
+struct ModelSource {
+    std::string header;  // <类名>.h
+    std::string source;  // <类名>.cpp
+    std::string driver;  // <类名>_main.cpp：命令行驱动程序
+};
+
+// 把网表导出为独立的 C++ 仿真模型：一个保存输入、输出和状态位的结构体，
+// 以及按逻辑深度展开的直线型 eval()，不依赖本项目的任何头文件。
+// 每个线网是一个 64 位字，每一位是一个独立的仿真通道，可一次仿真 64 组激励
+class ModelExporter {
+public:
+    // 生成源码；组合部分有环时返回 false
+    static bool Generate(const Netlist& netlist, const std::string& className, ModelSource& model,
+        std::string* error = nullptr);
+
+    // 在 directory 下写出 <类名>.h、<类名>.cpp 和 <类名>_main.cpp
+    static bool Write(const Netlist& netlist, const std::string& directory, const std::string& className,
+        std::string* error = nullptr);
+
+    // 把任意字符串变成合法的 C++ 标识符
+    static std::string SanitizeIdentifier(const std::string& name);
+};
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <string>
+#include <vector>
+#include "Enums.h"
+
+// 网表中的元件：只保留类型和引脚所连接的线网，不含任何绘图信息
+struct NetlistElement {
+    ElementType type;
+    std::vector<int> inputs;   // 每个输入引脚所在的线网（0 表示未连接，恒为低电平）
+    std::vector<int> outputs;  // 每个输出引脚驱动的线网
+    bool value;                // 输入/输出元件的当前值
+    int x;                     // 画布坐标（用于文件读写时按引脚位置恢复导线）
+    int y;
+    std::string attributes;    // 文件中坐标之后的其余字段，原样保留
+};
+
+// 扁平网表：每个输出引脚对应一个线网，输入引脚通过导线读取驱动它的线网
+class Netlist {
+public:
+    // 线网0保留为常量0，供未连接的输入引脚使用
+    enum : int { CONST_ZERO_NET = 0 };
+
+    Netlist() : netCount(1) {}
+
+    // 分配一个新的线网编号
+    int AddNet() { return netCount++; }
+
+    // 添加元件，返回其在网表中的下标
+    int AddElement(ElementType type, bool value = false, int x = 0, int y = 0) {
+        elements.push_back(NetlistElement{ type, {}, {}, value, x, y, std::string() });
+        return static_cast<int>(elements.size()) - 1;
+    }
+
+    int GetNetCount() const { return netCount; }
+    std::vector<NetlistElement>& GetElements() { return elements; }
+    const std::vector<NetlistElement>& GetElements() const { return elements; }
+
+    void Clear() {
+        elements.clear();
+        netCount = 1;
+    }
+
+private:
+    std::vector<NetlistElement> elements;  // 元件列表（与画布中的顺序一致）
+    int netCount;                          // 线网数量（含常量线网）
+};
+
+#endif
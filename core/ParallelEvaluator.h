@@ -0,0 +1,59 @@
+#pragma once
+#ifndef PARALLELEVALUATOR_H
+#define PARALLELEVALUATOR_H
+
+#include <memory>
+#include "CompiledCircuit.h"
+#include "WorkStealingPool.h"
+
+// 按层并行求值：每层的指令互不依赖，拆成若干块交给线程池，层与层之间等待全部完成。
+// 门数较少的层直接在调用线程执行，避免同步开销
+class ParallelEvaluator {
+public:
+    // 默认值：少于此门数的层不并行；每块的门数
+    static const size_t DEFAULT_INLINE_THRESHOLD = 4096;
+    static const size_t DEFAULT_GRAIN = 1024;
+
+    explicit ParallelEvaluator(unsigned workerCount = WorkStealingPool::DefaultWorkerCount())
+        : workerCount(workerCount), inlineThreshold(DEFAULT_INLINE_THRESHOLD), grain(DEFAULT_GRAIN),
+        parallelLevels(0) {}
+
+    void SetInlineThreshold(size_t gates) { inlineThreshold = gates; }
+    void SetGrain(size_t gates) { grain = gates > 0 ? gates : 1; }
+    unsigned GetWorkerCount() const { return workerCount; }
+
+    // 最近一次求值中交给线程池的层数
+    size_t GetParallelLevelCount() const { return parallelLevels; }
+
+    template <typename Word>
+    void Evaluate(const CompiledCircuit& circuit, Word* values) {
+        values[Netlist::CONST_ZERO_NET] = 0;
+        const auto& levelStart = circuit.GetLevelStart();
+        parallelLevels = 0;
+        for (uint32_t level = 0; level < circuit.GetLevelCount(); ++level) {
+            uint32_t begin = levelStart[level];
+            uint32_t end = levelStart[level + 1];
+            if (workerCount == 0 || end - begin < inlineThreshold) {
+                circuit.EvaluateRange(values, begin, end);
+                continue;
+            }
+
+            // 线程池在第一次需要时才创建
+            if (!pool) pool.reset(new WorkStealingPool(workerCount));
+            auto chunk = [&circuit, values, begin](size_t first, size_t last) {
+                circuit.EvaluateRange(values, begin + static_cast<uint32_t>(first), begin + static_cast<uint32_t>(last));
+            };
+            pool->ParallelFor(end - begin, grain, chunk);
+            parallelLevels++;
+        }
+    }
+
+private:
+    unsigned workerCount;                    // 工作线程数（0 表示全部在调用线程执行）
+    size_t inlineThreshold;                  // 少于此门数的层直接执行
+    size_t grain;                            // 每块的门数
+    size_t parallelLevels;                   // 最近一次并行执行的层数
+    std::unique_ptr<WorkStealingPool> pool;  // 按需创建的线程池
+};
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef PARALLELTRUTHTABLE_H
+#define PARALLELTRUTHTABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TruthTable.h"
+
+// 多线程真值表生成：行空间按字（64 行）切成互不相交的块，工作线程用原子计数器领取，
+// 每个线程有自己的向量化求值缓冲，结果直接写入共享的打包输出位（各块写不同的字）。
+// Start 立即返回，调用者可以查询进度、取消或等待完成
+class ParallelTruthTable {
+public:
+    // 每块的字数（16384 行），足够摊薄领取开销，又能让进度平滑推进
+    enum : size_t { CHUNK_WORDS = 256 };
+
+    ParallelTruthTable() : totalWords(0), nextWord(0), doneWords(0), cancelled(false), runningThreads(0) {}
+
+    ~ParallelTruthTable() {
+        Cancel();
+        Join();
+    }
+
+    ParallelTruthTable(const ParallelTruthTable&) = delete;
+    ParallelTruthTable& operator=(const ParallelTruthTable&) = delete;
+
+    // 开始生成 circuit 的真值表（circuit 会被复制，调用者无需保持其有效）；threadCount 为 0 时使用全部硬件线程
+    void Start(const CompiledCircuit& circuit, unsigned threadCount = 0) {
+        Cancel();
+        Join();
+        this->circuit = circuit;
+        BitParallelTruthTable::Prepare(this->circuit, table);
+        totalWords = table.wordsPerOutput;
+        nextWord.store(0);
+        doneWords.store(0);
+        cancelled.store(false);
+
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunks = (totalWords + CHUNK_WORDS - 1) / CHUNK_WORDS;
+        threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, chunks));
+        runningThreads = threadCount;
+        for (unsigned i = 0; i < threadCount; ++i) workers.emplace_back(&ParallelTruthTable::WorkerLoop, this);
+    }
+
+    // 请求取消；工作线程在当前块结束后退出
+    void Cancel() { cancelled.store(true); }
+
+    bool IsCancelled() const { return cancelled.load(); }
+
+    // 等待全部工作线程结束，最多等待 timeout；已结束时返回 true
+    bool WaitFor(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        return doneCondition.wait_for(lock, timeout, [this] { return runningThreads == 0; });
+    }
+
+    // 等待完成；返回 false 表示被取消，表格不完整
+    bool Wait() {
+        Join();
+        return !cancelled.load() && doneWords.load() == totalWords;
+    }
+
+    // 已完成的比例（0 到 1）
+    double GetProgress() const {
+        return totalWords == 0 ? 1.0 : static_cast<double>(doneWords.load()) / totalWords;
+    }
+
+    // 生成结果；应在 Wait 返回 true 后读取
+    TruthTableData& GetTable() { return table; }
+
+private:
+    void WorkerLoop() {
+        std::vector<uint64_t> values;
+        VectorizedCircuit vectorized;
+        bool vectorize = totalWords >= VectorizedCircuit::WORDS_PER_VECTOR;
+        if (vectorize) {
+            vectorized.Build(circuit, std::min(BitParallelTruthTable::ChooseBlockWords(circuit), size_t(CHUNK_WORDS)));
+        }
+
+        while (!cancelled.load(std::memory_order_relaxed)) {
+            size_t first = nextWord.fetch_add(CHUNK_WORDS);
+            if (first >= totalWords) break;
+            size_t last = std::min(totalWords, first + CHUNK_WORDS);
+            if (vectorize) BitParallelTruthTable::GenerateRange(vectorized, table, first, last);
+            else BitParallelTruthTable::GenerateRange(circuit, table, first, last, values);
+            doneWords.fetch_add(last - first);
+        }
+
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--runningThreads == 0) doneCondition.notify_all();
+    }
+
+    void Join() {
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    CompiledCircuit circuit;              // 工作线程共享的只读电路
+    TruthTableData table;                 // 共享的打包输出位
+    size_t totalWords;
+    std::atomic<size_t> nextWord;         // 下一个待领取的字
+    std::atomic<size_t> doneWords;        // 已完成的字数
+    std::atomic<bool> cancelled;
+    std::vector<std::thread> workers;
+    std::mutex doneMutex;                 // 保护 runningThreads
+    std::condition_variable doneCondition;
+    unsigned runningThreads;
+};
+
+#endif
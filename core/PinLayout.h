@@ -0,0 +1,52 @@
+#pragma once
+#ifndef PINLAYOUT_H
+#define PINLAYOUT_H
+
+#include <vector>
+#include "Enums.h"
+
+// 引脚相对元件中心的偏移
+struct PinOffset {
+    int dx;
+    int dy;
+    bool input;
+};
+
+// 各类元件的引脚布局，顺序与 GUI 元件的 GetPins() 一致（与 Gate.h、InputOutput.h、Sequence.h 的构造函数保持同步）
+inline std::vector<PinOffset> GetPinLayout(ElementType type) {
+    switch (type) {
+    case TYPE_INPUT:
+    case TYPE_CLOCK:
+        return { { 20, 0, false } };
+    case TYPE_OUTPUT:
+        return { { -20, 0, true } };
+    case TYPE_NOT:
+        return { { -40, 0, true }, { 40, 0, false } };
+    case TYPE_AND:
+    case TYPE_OR:
+    case TYPE_XOR:
+    case TYPE_NAND:
+    case TYPE_NOR:
+        return { { -40, -20, true }, { -40, 20, true }, { 40, 0, false } };
+    case TYPE_RS_FLIPFLOP:  // S, R, Q, Q'
+        return { { -20, -15, true }, { -20, 15, true }, { 20, -10, false }, { 20, 10, false } };
+    case TYPE_D_FLIPFLOP:   // D, CLK, Q, Q'
+        return { { -20, -15, true }, { -20, 0, true }, { 20, -10, false }, { 20, 10, false } };
+    case TYPE_JK_FLIPFLOP:  // J, K, CLK, Q, Q'
+        return { { -20, -20, true }, { -20, 0, true }, { -20, 20, true }, { 20, -10, false }, { 20, 10, false } };
+    case TYPE_T_FLIPFLOP:   // T, CLK, Q, Q'
+        return { { -20, -10, true }, { -20, 10, true }, { 20, -10, false }, { 20, 10, false } };
+    case TYPE_REGISTER: {   // D0-D3, CLK, LOAD, Q0-Q3
+        std::vector<PinOffset> layout;
+        for (int i = 0; i < 4; i++) layout.push_back({ -30, -30 + i * 15, true });
+        layout.push_back({ -30, 30, true });
+        layout.push_back({ -30, 45, true });
+        for (int i = 0; i < 4; i++) layout.push_back({ 30, -30 + i * 15, false });
+        return layout;
+    }
+    default:
+        return {};
+    }
+}
+
+#endif
@@ -0,0 +1,391 @@
+#include "SatSolver.h"
+
+#include <algorithm>
+
+namespace {
+
+    const SatLiteral NO_LITERAL = ~0u;
+
+    // 活跃度衰减系数
+    const double VARIABLE_DECAY = 0.95;
+    const double CLAUSE_DECAY = 0.999;
+
+    // 每次重启允许的冲突数 = Luby 序列 x RESTART_UNIT
+    const uint64_t RESTART_UNIT = 100;
+
+    // 学习子句上限：初始为原始子句数的 1/3（至少 LEARNT_MINIMUM），每次删除后增长 10%
+    const double LEARNT_MINIMUM = 1000;
+    const double LEARNT_GROWTH = 1.1;
+
+}
+
+SatSolver::SatSolver()
+    : propagateHead(0), variableIncrement(1), clauseIncrement(1), learntCount(0), maxLearnts(0), ok(true),
+    conflictLimit(0), conflicts(0), decisions(0), propagations(0) {
+}
+
+int SatSolver::NewVariable() {
+    int var = GetVariableCount();
+    assigns.push_back(VALUE_UNDEF);
+    levels.push_back(0);
+    reasons.push_back(NO_REASON);
+    polarity.push_back(true);
+    seen.push_back(false);
+    activity.push_back(0);
+    heapIndex.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    HeapInsert(var);
+    return var;
+}
+
+bool SatSolver::AddClause(std::vector<SatLiteral> clause) {
+    if (!ok) return false;
+
+    // 去重；恒真或已满足的子句直接丢弃，去掉已为假的文字
+    std::sort(clause.begin(), clause.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < clause.size(); ++i) {
+        SatLiteral lit = clause[i];
+        if (Value(lit) == VALUE_TRUE || (i > 0 && lit == Negate(clause[i - 1]))) return true;
+        if (Value(lit) == VALUE_FALSE || (i > 0 && lit == clause[i - 1])) continue;
+        clause[kept++] = lit;
+    }
+    clause.resize(kept);
+
+    if (clause.empty()) {
+        ok = false;
+        return false;
+    }
+    if (clause.size() == 1) {
+        Enqueue(clause[0], NO_REASON);
+        ok = Propagate() == NO_REASON;
+        return ok;
+    }
+    Attach(std::move(clause), false);
+    return true;
+}
+
+uint32_t SatSolver::Attach(std::vector<SatLiteral> lits, bool learnt) {
+    uint32_t index = static_cast<uint32_t>(clauses.size());
+    watches[Negate(lits[0])].push_back(Watcher{ index, lits[1] });
+    watches[Negate(lits[1])].push_back(Watcher{ index, lits[0] });
+    clauses.push_back(Clause{ std::move(lits), 0, learnt, false });
+    return index;
+}
+
+void SatSolver::Enqueue(SatLiteral lit, uint32_t reason) {
+    int var = VariableOf(lit);
+    assigns[var] = (lit & 1) ? VALUE_FALSE : VALUE_TRUE;
+    levels[var] = DecisionLevel();
+    reasons[var] = reason;
+    trail.push_back(lit);
+}
+
+// 单元传播；返回冲突子句，无冲突时返回 NO_REASON。
+// watches[p] 中是观察 ¬p 的子句，p 为真时检查
+uint32_t SatSolver::Propagate() {
+    while (propagateHead < trail.size()) {
+        SatLiteral p = trail[propagateHead++];
+        SatLiteral falseLit = Negate(p);
+        std::vector<Watcher>& ws = watches[p];
+        propagations++;
+
+        size_t i = 0, j = 0;
+        while (i < ws.size()) {
+            Watcher w = ws[i++];
+            if (Value(w.blocker) == VALUE_TRUE) {
+                ws[j++] = w;
+                continue;
+            }
+
+            std::vector<SatLiteral>& lits = clauses[w.clause].lits;
+            if (lits[0] == falseLit) std::swap(lits[0], lits[1]);
+            SatLiteral first = lits[0];
+            Watcher updated{ w.clause, first };
+            if (first != w.blocker && Value(first) == VALUE_TRUE) {
+                ws[j++] = updated;
+                continue;
+            }
+
+            // 寻找新的观察文字
+            bool moved = false;
+            for (size_t k = 2; k < lits.size(); ++k) {
+                if (Value(lits[k]) == VALUE_FALSE) continue;
+                std::swap(lits[1], lits[k]);
+                watches[Negate(lits[1])].push_back(updated);
+                moved = true;
+                break;
+            }
+            if (moved) continue;
+
+            // 子句为单元或冲突
+            ws[j++] = updated;
+            if (Value(first) == VALUE_FALSE) {
+                while (i < ws.size()) ws[j++] = ws[i++];
+                ws.resize(j);
+                propagateHead = trail.size();
+                return w.clause;
+            }
+            Enqueue(first, w.clause);
+        }
+        ws.resize(j);
+    }
+    return NO_REASON;
+}
+
+// 第一唯一蕴涵点学习：learnt[0] 为回跳后被蕴涵的文字，learnt[1] 为回跳层上的文字
+void SatSolver::Analyze(uint32_t conflict, std::vector<SatLiteral>& learnt, int& backtrackLevel) {
+    learnt.assign(1, NO_LITERAL);
+    int pathCount = 0;
+    SatLiteral p = NO_LITERAL;
+    size_t index = trail.size();
+
+    do {
+        Clause& clause = clauses[conflict];
+        if (clause.learnt) BumpClause(clause);
+        for (size_t k = (p == NO_LITERAL) ? 0 : 1; k < clause.lits.size(); ++k) {
+            SatLiteral q = clause.lits[k];
+            int var = VariableOf(q);
+            if (seen[var] || levels[var] == 0) continue;
+            BumpVariable(var);
+            seen[var] = true;
+            if (levels[var] >= DecisionLevel()) pathCount++;
+            else learnt.push_back(q);
+        }
+        // 沿赋值序列找下一个待展开的当前层文字
+        while (!seen[VariableOf(trail[--index])]) {}
+        p = trail[index];
+        conflict = reasons[VariableOf(p)];
+        seen[VariableOf(p)] = false;
+        pathCount--;
+    } while (pathCount > 0);
+    learnt[0] = Negate(p);
+
+    // 局部最小化：原因子句的其余文字都已在学习子句中的文字可以去掉
+    std::vector<SatLiteral> collected(learnt.begin() + 1, learnt.end());
+    size_t kept = 1;
+    for (size_t k = 1; k < learnt.size(); ++k) {
+        if (reasons[VariableOf(learnt[k])] == NO_REASON || !Redundant(learnt[k])) learnt[kept++] = learnt[k];
+    }
+    learnt.resize(kept);
+    for (SatLiteral lit : collected) seen[VariableOf(lit)] = false;
+
+    backtrackLevel = 0;
+    if (learnt.size() > 1) {
+        size_t maxIndex = 1;
+        for (size_t k = 2; k < learnt.size(); ++k) {
+            if (levels[VariableOf(learnt[k])] > levels[VariableOf(learnt[maxIndex])]) maxIndex = k;
+        }
+        std::swap(learnt[1], learnt[maxIndex]);
+        backtrackLevel = levels[VariableOf(learnt[1])];
+    }
+}
+
+bool SatSolver::Redundant(SatLiteral lit) const {
+    const Clause& reason = clauses[reasons[VariableOf(lit)]];
+    for (size_t k = 1; k < reason.lits.size(); ++k) {
+        int var = VariableOf(reason.lits[k]);
+        if (!seen[var] && levels[var] > 0) return false;
+    }
+    return true;
+}
+
+void SatSolver::Backtrack(int level) {
+    if (DecisionLevel() <= level) return;
+    for (size_t i = trail.size(); i-- > trailLimits[level];) {
+        int var = VariableOf(trail[i]);
+        assigns[var] = VALUE_UNDEF;
+        reasons[var] = NO_REASON;
+        polarity[var] = (trail[i] & 1) != 0;
+        if (heapIndex[var] < 0) HeapInsert(var);
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    propagateHead = trail.size();
+}
+
+SatLiteral SatSolver::PickBranch() {
+    while (!heap.empty()) {
+        int var = HeapPop();
+        if (assigns[var] == VALUE_UNDEF) return polarity[var] ? Negative(var) : Positive(var);
+    }
+    return NO_LITERAL;
+}
+
+SatSolver::Result SatSolver::Solve() {
+    model.clear();
+    if (!ok) return UNSAT;
+    if (maxLearnts == 0) maxLearnts = std::max(LEARNT_MINIMUM, clauses.size() / 3.0);
+
+    const uint64_t startConflicts = conflicts;
+    std::vector<SatLiteral> learnt;
+    for (uint64_t restart = 0;; ++restart) {
+        const uint64_t budget = Luby(restart) * RESTART_UNIT;
+        uint64_t restartConflicts = 0;
+        for (;;) {
+            uint32_t conflict = Propagate();
+            if (conflict != NO_REASON) {
+                conflicts++;
+                restartConflicts++;
+                if (DecisionLevel() == 0) {
+                    ok = false;
+                    return UNSAT;
+                }
+                int backtrackLevel;
+                Analyze(conflict, learnt, backtrackLevel);
+                Backtrack(backtrackLevel);
+                if (learnt.size() == 1) {
+                    Enqueue(learnt[0], NO_REASON);
+                }
+                else {
+                    uint32_t index = Attach(learnt, true);
+                    BumpClause(clauses[index]);
+                    Enqueue(learnt[0], index);
+                    learntCount++;
+                }
+                variableIncrement /= VARIABLE_DECAY;
+                clauseIncrement /= CLAUSE_DECAY;
+                if (conflictLimit != 0 && conflicts - startConflicts >= conflictLimit) {
+                    Backtrack(0);
+                    return UNKNOWN;
+                }
+                continue;
+            }
+
+            if (restartConflicts >= budget) break;
+            SatLiteral next = PickBranch();
+            if (next == NO_LITERAL) {
+                model.resize(assigns.size());
+                for (size_t var = 0; var < assigns.size(); ++var) model[var] = assigns[var] == VALUE_TRUE;
+                Backtrack(0);
+                return SAT;
+            }
+            decisions++;
+            trailLimits.push_back(trail.size());
+            Enqueue(next, NO_REASON);
+        }
+
+        // 重启：回到第 0 层，学习子句过多时删除不活跃的一半
+        Backtrack(0);
+        if (learntCount >= maxLearnts + trail.size()) {
+            ReduceLearnts();
+            maxLearnts *= LEARNT_GROWTH;
+        }
+    }
+}
+
+// 只在第 0 层调用：此时没有子句作为非零层赋值的原因，可以直接删除并压缩子句表
+void SatSolver::ReduceLearnts() {
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < clauses.size(); ++i) {
+        if (clauses[i].learnt && clauses[i].lits.size() > 2) candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return clauses[a].activity < clauses[b].activity;
+    });
+    for (size_t k = 0; k < candidates.size() / 2; ++k) clauses[candidates[k]].deleted = true;
+
+    size_t kept = 0;
+    learntCount = 0;
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (clauses[i].deleted) continue;
+        if (clauses[i].learnt) learntCount++;
+        if (kept != i) clauses[kept] = std::move(clauses[i]);
+        kept++;
+    }
+    clauses.resize(kept);
+    for (SatLiteral lit : trail) reasons[VariableOf(lit)] = NO_REASON;
+    RebuildWatches();
+}
+
+void SatSolver::RebuildWatches() {
+    for (auto& ws : watches) ws.clear();
+    for (uint32_t i = 0; i < clauses.size(); ++i) {
+        const std::vector<SatLiteral>& lits = clauses[i].lits;
+        watches[Negate(lits[0])].push_back(Watcher{ i, lits[1] });
+        watches[Negate(lits[1])].push_back(Watcher{ i, lits[0] });
+    }
+}
+
+void SatSolver::BumpVariable(int var) {
+    activity[var] += variableIncrement;
+    if (activity[var] > 1e100) {
+        for (double& a : activity) a *= 1e-100;
+        variableIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0) HeapUp(static_cast<size_t>(heapIndex[var]));
+}
+
+void SatSolver::BumpClause(Clause& clause) {
+    clause.activity += clauseIncrement;
+    if (clause.activity > 1e20) {
+        for (Clause& c : clauses) {
+            if (c.learnt) c.activity *= 1e-20;
+        }
+        clauseIncrement *= 1e-20;
+    }
+}
+
+void SatSolver::HeapInsert(int var) {
+    heapIndex[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    HeapUp(heap.size() - 1);
+}
+
+int SatSolver::HeapPop() {
+    int top = heap[0];
+    heapIndex[top] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        heapIndex[last] = 0;
+        HeapDown(0);
+    }
+    return top;
+}
+
+void SatSolver::HeapUp(size_t pos) {
+    int var = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!HeapLess(var, heap[parent])) break;
+        heap[pos] = heap[parent];
+        heapIndex[heap[pos]] = static_cast<int>(pos);
+        pos = parent;
+    }
+    heap[pos] = var;
+    heapIndex[var] = static_cast<int>(pos);
+}
+
+void SatSolver::HeapDown(size_t pos) {
+    int var = heap[pos];
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= heap.size()) break;
+        if (child + 1 < heap.size() && HeapLess(heap[child + 1], heap[child])) child++;
+        if (!HeapLess(heap[child], var)) break;
+        heap[pos] = heap[child];
+        heapIndex[heap[pos]] = static_cast<int>(pos);
+        pos = child;
+    }
+    heap[pos] = var;
+    heapIndex[var] = static_cast<int>(pos);
+}
+
+// Luby 重启序列 1, 1, 2, 1, 1, 2, 4, ...
+uint64_t SatSolver::Luby(uint64_t i) {
+    uint64_t size = 1;
+    int seq = 0;
+    while (size < i + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != i) {
+        size = (size - 1) >> 1;
+        seq--;
+        i = i % size;
+    }
+    return uint64_t(1) << seq;
+}
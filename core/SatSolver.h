@@ -0,0 +1,116 @@
+#pragma once
+#ifndef SATSOLVER_H
+#define SATSOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 文字：变量 v 的正文字为 2v，负文字为 2v+1
+typedef uint32_t SatLiteral;
+
+// 冲突驱动子句学习（CDCL）SAT 求解器：双观察文字传播、第一唯一蕴涵点学习与子句最小化、
+// VSIDS 变量活跃度、相位保存、Luby 序列重启，以及按活跃度定期删除一半学习子句
+class SatSolver {
+public:
+    enum Result { SAT, UNSAT, UNKNOWN };
+
+    SatSolver();
+
+    static SatLiteral Positive(int var) { return static_cast<SatLiteral>(var) << 1; }
+    static SatLiteral Negative(int var) { return (static_cast<SatLiteral>(var) << 1) | 1; }
+    static SatLiteral Negate(SatLiteral lit) { return lit ^ 1; }
+    static int VariableOf(SatLiteral lit) { return static_cast<int>(lit >> 1); }
+
+    int NewVariable();
+    int GetVariableCount() const { return static_cast<int>(assigns.size()); }
+
+    // 添加子句（在 Solve 之前）；已能推出矛盾时返回 false
+    bool AddClause(std::vector<SatLiteral> clause);
+
+    // 冲突数上限（0 为不限）；达到上限时 Solve 返回 UNKNOWN
+    void SetConflictLimit(uint64_t limit) { conflictLimit = limit; }
+
+    Result Solve();
+
+    // Solve 返回 SAT 后变量的取值
+    bool GetModelValue(int var) const { return model[var]; }
+
+    uint64_t GetConflictCount() const { return conflicts; }
+    uint64_t GetDecisionCount() const { return decisions; }
+    uint64_t GetPropagationCount() const { return propagations; }
+
+private:
+    enum : uint32_t { NO_REASON = ~0u };
+    enum : int8_t { VALUE_FALSE = 0, VALUE_TRUE = 1, VALUE_UNDEF = -1 };
+
+    struct Clause {
+        std::vector<SatLiteral> lits;   // lits[0] 和 lits[1] 为观察文字
+        double activity;
+        bool learnt;
+        bool deleted;
+    };
+
+    // 观察表项：blocker 为真时无需访问子句
+    struct Watcher {
+        uint32_t clause;
+        SatLiteral blocker;
+    };
+
+    int8_t Value(SatLiteral lit) const {
+        int8_t value = assigns[lit >> 1];
+        if (value == VALUE_UNDEF) return VALUE_UNDEF;
+        return static_cast<int8_t>(value ^ (lit & 1));
+    }
+    int DecisionLevel() const { return static_cast<int>(trailLimits.size()); }
+
+    uint32_t Attach(std::vector<SatLiteral> lits, bool learnt);
+    void Enqueue(SatLiteral lit, uint32_t reason);
+    uint32_t Propagate();
+    void Analyze(uint32_t conflict, std::vector<SatLiteral>& learnt, int& backtrackLevel);
+    bool Redundant(SatLiteral lit) const;
+    void Backtrack(int level);
+    SatLiteral PickBranch();
+    void ReduceLearnts();
+    void RebuildWatches();
+
+    void BumpVariable(int var);
+    void BumpClause(Clause& clause);
+
+    // 按活跃度排序的变量堆
+    bool HeapLess(int a, int b) const { return activity[a] > activity[b]; }
+    void HeapInsert(int var);
+    int HeapPop();
+    void HeapUp(size_t pos);
+    void HeapDown(size_t pos);
+
+    static uint64_t Luby(uint64_t i);
+
+    std::vector<Clause> clauses;
+    std::vector<std::vector<Watcher>> watches;   // 按文字索引
+    std::vector<int8_t> assigns;
+    std::vector<int> levels;
+    std::vector<uint32_t> reasons;
+    std::vector<bool> polarity;                  // 保存的相位（上次赋值为假时为 true）
+    std::vector<bool> seen;
+    std::vector<SatLiteral> trail;
+    std::vector<size_t> trailLimits;
+    size_t propagateHead;
+
+    std::vector<double> activity;
+    std::vector<int> heap;
+    std::vector<int> heapIndex;                  // 变量在堆中的位置，-1 表示不在堆中
+    double variableIncrement;
+    double clauseIncrement;
+
+    std::vector<bool> model;
+    size_t learntCount;
+    double maxLearnts;
+    bool ok;
+    uint64_t conflictLimit;
+    uint64_t conflicts;
+    uint64_t decisions;
+    uint64_t propagations;
+};
+
+#endif
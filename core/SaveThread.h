@@ -0,0 +1,129 @@
+#pragma once
+#ifndef SAVETHREAD_H
+#define SAVETHREAD_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CircuitSnapshot.h"
+
+// 后台保存线程：界面线程提交电路快照，工作线程按提交顺序写文件，界面线程定期取走结果。
+// 快照提交后不再修改，工作线程只读；任务队列和结果通过 mutex 交换。还没开始写的自动保存任务
+// 被同一文件的新自动保存替换，保存慢于编辑时不会积压
+class SaveThread {
+public:
+    struct Result {
+        std::string filename;
+        bool autosave;
+        bool ok;
+        std::string error;
+        uint64_t bytes;
+        double seconds;  // 写文件的耗时（不含排队）
+        uint64_t tag;    // 提交时调用者给的标记，原样带回
+    };
+
+    SaveThread() : stopping(false), writing(false) {}
+
+    // 写完已提交的任务再退出，关闭窗口时不丢失正在保存的内容
+    ~SaveThread() { Stop(); }
+
+    SaveThread(const SaveThread&) = delete;
+    SaveThread& operator=(const SaveThread&) = delete;
+
+    void Submit(std::shared_ptr<const CircuitSnapshot> snapshot, const std::string& filename, bool autosave, uint64_t tag = 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool replaced = false;
+            if (autosave) {
+                for (Job& job : jobs) {
+                    if (job.autosave && job.filename == filename) {
+                        job.snapshot = snapshot;
+                        job.tag = tag;
+                        replaced = true;
+                        break;
+                    }
+                }
+            }
+            if (!replaced) jobs.push_back(Job{ std::move(snapshot), filename, autosave, tag });
+            if (!worker.joinable()) {
+                stopping = false;
+                worker = std::thread(&SaveThread::WorkerLoop, this);
+            }
+        }
+        wakeup.notify_all();
+    }
+
+    // 还有排队或正在写的任务
+    bool IsBusy() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return writing || !jobs.empty();
+    }
+
+    // 取走已完成的结果（按完成顺序）
+    bool TakeResults(std::vector<Result>& taken) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (results.empty()) return false;
+        taken.clear();
+        taken.swap(results);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!worker.joinable()) return;
+            stopping = true;
+        }
+        wakeup.notify_all();
+        worker.join();
+    }
+
+private:
+    struct Job {
+        std::shared_ptr<const CircuitSnapshot> snapshot;
+        std::string filename;
+        bool autosave;
+        uint64_t tag;
+    };
+
+    void WorkerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wakeup.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) break;  // 只在队列清空后响应 stopping
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            writing = true;
+            lock.unlock();
+
+            Result result;
+            result.filename = job.filename;
+            result.autosave = job.autosave;
+            result.bytes = 0;
+            result.tag = job.tag;
+            auto start = std::chrono::steady_clock::now();
+            result.ok = job.snapshot->Save(job.filename, &result.error, &result.bytes);
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            job.snapshot.reset();  // 尽早释放快照
+
+            lock.lock();
+            writing = false;
+            results.push_back(std::move(result));
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<Job> jobs;
+    std::vector<Result> results;
+    bool stopping;
+    bool writing;
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,364 @@
+#pragma once
+#ifndef SEQUENTIALCIRCUIT_H
+#define SEQUENTIALCIRCUIT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "CompiledCircuit.h"
+#include "TimingWheel.h"
+
+// 基于周期的时序电路仿真：组合部分按 CompiledCircuit 分层求值，时序元件的输出作为伪输入。
+// 每一步分两个阶段：先推进时钟并稳定组合逻辑，再让所有时序元件根据当前线网值同时采样，
+// 统一提交新状态后再稳定一次组合逻辑。
+//
+// 状态位布局（与 GUI 元件的 GetStateBits/SetStateBits 一致）：
+//   时钟：bit0 为输出值，其余位为分频计数器
+//   RS 触发器：bit0 = Q，bit1 = Q'
+//   D/JK/T 触发器：bit0 = Q
+//   寄存器：bit0..bit3 = Q0..Q3
+//
+// 推进方式有两种：Step() 按步推进，时钟每 frequency 步翻转一次（与 ClockElement::Update 一致）；
+// StepToNextEdge() 按仿真时间推进，时钟频率按 Hz 解释，每半个周期翻转一次。
+// 各时钟的下一次翻转登记在分层时间轮中，直接跳到最近的边沿，推进代价只与边沿数有关
+
+// 某一时刻的仿真结果，供其他线程读取
+struct SequentialSnapshot {
+    std::vector<uint8_t> values;   // 线网值（0x00/0xFF）
+    std::vector<uint32_t> states;  // 网表下标 -> 状态位（组合元件为 0）
+    uint64_t steps = 0;            // 已执行的步数（或时钟边沿数）
+    uint64_t time = 0;             // 仿真时间（纳秒）
+    uint64_t transitions = 0;      // 时序元件状态变化的累计次数
+};
+
+class SequentialCircuit {
+public:
+    // 没有可推进的时钟时 GetNextEdgeTime() 的返回值
+    enum : uint64_t { NO_EDGE = TimingWheel::NO_EVENT };
+
+    SequentialCircuit() : stepCount(0), transitionCount(0), time(0), settlePending(false) {}
+
+    // 编译网表；时序元件的初始状态和时钟参数取自元件的附加字段（与文件格式相同）
+    bool Compile(const Netlist& netlist) {
+        states.clear();
+        clocks.clear();
+        flops.clear();
+        stateIndex.assign(netlist.GetElements().size(), -1);
+        if (!combinational.Compile(netlist, true)) {
+            values.clear();
+            return false;
+        }
+
+        const auto& elements = netlist.GetElements();
+        for (int index : combinational.GetSequentialElements()) {
+            const NetlistElement& element = elements[index];
+            StateElement state;
+            state.type = element.type;
+            state.element = index;
+            for (size_t k = 0; k < MAX_PORTS; ++k) {
+                state.inputs[k] = k < element.inputs.size() ? element.inputs[k] : Netlist::CONST_ZERO_NET;
+                state.outputs[k] = k < element.outputs.size() ? element.outputs[k] : Netlist::CONST_ZERO_NET;
+            }
+            state.outputCount = static_cast<uint32_t>(element.outputs.size());
+            ParseAttributes(element.attributes, state);
+
+            stateIndex[index] = static_cast<int>(states.size());
+            (element.type == TYPE_CLOCK ? clocks : flops).push_back(static_cast<int>(states.size()));
+            states.push_back(state);
+        }
+
+        values.assign(combinational.GetSlotCount(), 0);
+        const auto& inputSlots = combinational.GetInputSlots();
+        size_t input = 0;
+        for (const NetlistElement& element : elements) {
+            if (element.type == TYPE_INPUT) values[inputSlots[input++]] = element.value ? 0xFF : 0x00;
+        }
+        Reset();
+        return true;
+    }
+
+    // 恢复编译时的初始状态并稳定组合逻辑；当前时钟电平作为各元件上一次看到的时钟，避免伪边沿
+    void Reset() {
+        wheel.Reset(0);
+        for (StateElement& state : states) {
+            state.state = state.initialState;
+            state.counter = 0;
+            WriteOutputs(state);
+        }
+        for (int c : clocks) {
+            if (states[c].enabled) wheel.Schedule(c, HalfPeriod(states[c]));
+        }
+        Settle();
+        for (int f : flops) states[f].lastClock = values[states[f].inputs[ClockPort(states[f].type)]] != 0;
+        stepCount = 0;
+        transitionCount = 0;
+        time = 0;
+    }
+
+    // 执行 steps 步，返回状态发生变化的时序元件次数
+    size_t Run(size_t steps) {
+        size_t transitions = 0;
+        for (size_t s = 0; s < steps; ++s) transitions += Step();
+        return transitions;
+    }
+
+    // 单步：推进时钟 -> 稳定 -> 采样 -> 统一提交 -> 稳定
+    size_t Step() {
+        // 第一阶段：时钟分频计数，与 ClockElement::Update 的行为一致
+        for (int c : clocks) {
+            StateElement& clock = states[c];
+            if (!clock.enabled) continue;
+            if (++clock.counter >= clock.frequency) {
+                clock.state ^= 1u;
+                clock.counter = 0;
+                WriteOutputs(clock);
+                settlePending = true;
+            }
+        }
+        if (settlePending) Settle();
+        return SampleAndCommit();
+    }
+
+    // 按仿真时间推进到下一个时钟边沿，翻转该时刻到期的所有时钟后采样；没有使能的时钟时返回 false
+    bool StepToNextEdge() {
+        dueClocks.clear();
+        if (!wheel.PopNext(time, dueClocks)) return false;
+        for (int c : dueClocks) {
+            StateElement& clock = states[c];
+            clock.state ^= 1u;
+            wheel.Schedule(c, time + HalfPeriod(clock));
+            WriteOutputs(clock);
+        }
+        Settle();
+        SampleAndCommit();
+        return true;
+    }
+
+    // 下一个时钟边沿的仿真时间（纳秒）
+    uint64_t GetNextEdgeTime() const { return wheel.PeekNext(); }
+
+    // 复制当前结果（复用 snapshot 中已分配的缓冲）
+    void Capture(SequentialSnapshot& snapshot) const {
+        snapshot.values = values;
+        snapshot.states.assign(stateIndex.size(), 0);
+        for (const StateElement& state : states) snapshot.states[state.element] = GetState(state.element);
+        snapshot.steps = stepCount;
+        snapshot.time = time;
+        snapshot.transitions = transitionCount;
+    }
+
+    // 所有时序元件先根据同一组线网值计算新状态，再统一写出并稳定组合逻辑
+    size_t SampleAndCommit() {
+        changed.clear();
+        for (int f : flops) {
+            StateElement& flop = states[f];
+            uint32_t next = NextState(flop);
+            if (next != flop.state) {
+                flop.state = next;
+                changed.push_back(f);
+            }
+        }
+        for (int f : changed) WriteOutputs(states[f]);
+        if (!changed.empty()) Settle();
+
+        stepCount++;
+        transitionCount += changed.size();
+        return changed.size();
+    }
+
+    void SetInput(size_t input, bool value) {
+        uint8_t word = value ? 0xFF : 0x00;
+        uint8_t& slot = values[combinational.GetInputSlots()[input]];
+        if (slot == word) return;
+        slot = word;
+        settlePending = true;
+    }
+
+    bool GetInput(size_t input) const { return values[combinational.GetInputSlots()[input]] != 0; }
+    bool GetOutput(size_t output) const { return values[combinational.GetOutputSlots()[output]] != 0; }
+    bool GetNetValue(int net) const { return values[net] != 0; }
+
+    // 按网表下标读写时序元件的状态位；写入后需要调用 Settle() 让组合逻辑跟上
+    bool HasState(int element) const { return element >= 0 && element < static_cast<int>(stateIndex.size()) && stateIndex[element] >= 0; }
+    uint32_t GetState(int element) const {
+        const StateElement& state = states[stateIndex[element]];
+        return state.type == TYPE_CLOCK ? (state.state | (static_cast<uint32_t>(state.counter) << 1)) : state.state;
+    }
+    void SetState(int element, uint32_t bits) {
+        StateElement& state = states[stateIndex[element]];
+        if (state.type == TYPE_CLOCK) {
+            state.state = bits & 1u;
+            state.counter = static_cast<int>(bits >> 1);
+        }
+        else {
+            state.state = bits;
+        }
+        WriteOutputs(state);
+        settlePending = true;
+    }
+
+    // 时钟参数（element 为网表下标）
+    int GetClockFrequency(int element) const { return states[stateIndex[element]].frequency; }
+    bool IsClockEnabled(int element) const { return states[stateIndex[element]].enabled; }
+
+    // 重新求值组合逻辑
+    void Settle() {
+        combinational.Evaluate(values.data());
+        settlePending = false;
+    }
+
+    size_t GetInputCount() const { return combinational.GetInputSlots().size(); }
+    bool IsValid() const { return combinational.IsValid(); }
+    const std::string& GetError() const { return combinational.GetError(); }
+    const CompiledCircuit& GetCombinational() const { return combinational; }
+    size_t GetStateElementCount() const { return states.size(); }
+    size_t GetClockCount() const { return clocks.size(); }
+    uint64_t GetStepCount() const { return stepCount; }
+    uint64_t GetTime() const { return time; }
+    uint64_t GetTransitionCount() const { return transitionCount; }
+
+private:
+    enum : size_t { MAX_PORTS = 6 };  // 寄存器有 6 个输入（D0-D3、CLK、LOAD）
+
+    struct StateElement {
+        ElementType type;
+        int element;                  // 网表下标
+        uint32_t inputs[MAX_PORTS];   // 输入引脚所在线网
+        uint32_t outputs[MAX_PORTS];  // 输出引脚驱动的线网
+        uint32_t outputCount;
+        uint32_t state;               // 当前状态位
+        uint32_t initialState;        // 编译时的状态位
+        bool lastClock;               // 上一步采样到的时钟电平
+        int frequency;                // 时钟分频（每 frequency 步翻转一次）或频率（Hz）
+        int counter;
+        bool enabled;
+    };
+
+    // 时钟的半周期（纳秒）
+    static uint64_t HalfPeriod(const StateElement& clock) {
+        return 500000000ull / static_cast<uint64_t>(std::max(clock.frequency, 1));
+    }
+
+    // 各类元件 CLK 引脚的输入序号（RS 触发器为电平触发，返回 0 只用于初始化）
+    static size_t ClockPort(ElementType type) {
+        switch (type) {
+        case TYPE_D_FLIPFLOP: return 1;
+        case TYPE_JK_FLIPFLOP: return 2;
+        case TYPE_T_FLIPFLOP: return 1;
+        case TYPE_REGISTER: return 4;
+        default: return 0;
+        }
+    }
+
+    // 附加字段：时钟为 "频率,使能"，RS 为 "Q,Q'"，D/JK/T 为 "Q"，寄存器为 "D0,D1,D2,D3"
+    static void ParseAttributes(const std::string& attributes, StateElement& state) {
+        std::vector<long> fields;
+        const char* p = attributes.c_str();
+        while (*p) {
+            char* end;
+            long value = std::strtol(p, &end, 10);
+            if (end == p) break;
+            fields.push_back(value);
+            p = (*end == ',') ? end + 1 : end;
+        }
+        auto field = [&](size_t i, long fallback) { return i < fields.size() ? fields[i] : fallback; };
+
+        state.initialState = 0;
+        state.lastClock = false;
+        state.frequency = 1;
+        state.counter = 0;
+        state.enabled = true;
+        switch (state.type) {
+        case TYPE_CLOCK:
+            state.frequency = static_cast<int>(field(0, 1));
+            state.enabled = field(1, 1) != 0;
+            break;
+        case TYPE_RS_FLIPFLOP:
+            state.initialState = (field(0, 0) ? 1u : 0u) | (field(1, 1) ? 2u : 0u);
+            break;
+        case TYPE_REGISTER:
+            for (size_t i = 0; i < 4; ++i) state.initialState |= field(i, 0) ? (1u << i) : 0u;
+            break;
+        default:
+            state.initialState = field(0, 0) ? 1u : 0u;
+            break;
+        }
+        state.state = state.initialState;
+    }
+
+    bool In(const StateElement& state, size_t port) const { return values[state.inputs[port]] != 0; }
+
+    // 根据当前线网值计算新状态（与 Sequence.h 中各元件的 Update 逻辑一致）
+    uint32_t NextState(StateElement& flop) const {
+        if (flop.type == TYPE_RS_FLIPFLOP) {
+            bool s = In(flop, 0), r = In(flop, 1);
+            if (s && !r) return 1u;
+            if (!s && r) return 2u;
+            if (s && r) return 3u;  // 非法状态：Q 与 Q' 同为 1
+            return flop.state;
+        }
+
+        bool clock = In(flop, ClockPort(flop.type));
+        bool rising = clock && !flop.lastClock;
+        flop.lastClock = clock;
+        if (!rising) return flop.state;
+
+        switch (flop.type) {
+        case TYPE_D_FLIPFLOP:
+            return In(flop, 0) ? 1u : 0u;
+        case TYPE_JK_FLIPFLOP: {
+            bool j = In(flop, 0), k = In(flop, 1);
+            if (j && k) return flop.state ^ 1u;
+            if (j) return 1u;
+            if (k) return 0u;
+            return flop.state;
+        }
+        case TYPE_T_FLIPFLOP:
+            return In(flop, 0) ? flop.state ^ 1u : flop.state;
+        case TYPE_REGISTER: {
+            if (!In(flop, 5)) return flop.state;  // LOAD 为低时保持
+            uint32_t data = 0;
+            for (size_t i = 0; i < 4; ++i) data |= In(flop, i) ? (1u << i) : 0u;
+            return data;
+        }
+        default:
+            return flop.state;
+        }
+    }
+
+    // 把状态位写到输出线网
+    void WriteOutputs(const StateElement& state) {
+        for (uint32_t k = 0; k < state.outputCount; ++k) {
+            bool bit;
+            switch (state.type) {
+            case TYPE_D_FLIPFLOP:
+            case TYPE_JK_FLIPFLOP:
+            case TYPE_T_FLIPFLOP:
+                bit = k == 0 ? (state.state & 1u) != 0 : (state.state & 1u) == 0;  // Q, Q'
+                break;
+            default:
+                bit = (state.state >> k) & 1u;
+                break;
+            }
+            values[state.outputs[k]] = bit ? 0xFF : 0x00;
+        }
+    }
+
+    CompiledCircuit combinational;     // 组合部分
+    std::vector<StateElement> states;  // 所有时序元件（含时钟）
+    std::vector<int> clocks;           // states 中的时钟
+    std::vector<int> flops;            // states 中的触发器和寄存器
+    std::vector<int> stateIndex;       // 网表下标 -> states 下标（-1 表示组合元件）
+    std::vector<int> changed;          // 本步状态变化的元件（复用缓冲）
+    TimingWheel wheel;                 // 各时钟的下一次翻转（事件编号为 states 下标）
+    std::vector<int> dueClocks;        // 本边沿翻转的时钟（复用缓冲）
+    std::vector<uint8_t> values;       // 线网值（0x00/0xFF）
+    uint64_t stepCount;                // Reset 之后执行的步数
+    uint64_t transitionCount;          // Reset 之后状态变化的累计次数
+    uint64_t time;                     // 仿真时间（纳秒）
+    bool settlePending;                // 输入或状态已改变，组合逻辑尚未稳定
+};
+
+#endif
@@ -0,0 +1,234 @@
+#pragma once
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SequentialCircuit.h"
+
+// 后台仿真线程：在独立线程上按仿真时间推进时序电路，界面线程定期取走快照。
+// 仿真电路只由工作线程访问；输入值和模式通过 controlMutex 传递，快照通过 snapshotMutex 交换
+class SimulationThread {
+public:
+    enum Mode {
+        MODE_PAUSED,    // 暂停
+        MODE_REALTIME,  // 仿真时间跟随真实时间（乘以速度倍率）
+        MODE_FAST       // 尽可能快地推进
+    };
+
+    // 快照发布间隔；尽快模式下每批最多推进的时钟边沿数
+    enum : int { SNAPSHOT_INTERVAL_MS = 33, FAST_BATCH = 4096 };
+
+    SimulationThread() : mode(MODE_PAUSED), speed(1.0), stopping(false), controlDirty(false),
+        snapshotVersion(0), takenVersion(0) {}
+
+    ~SimulationThread() { Stop(); }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // 以 circuit 的当前状态为起点启动线程（已在运行时先停止）
+    void Start(const SequentialCircuit& circuit, Mode startMode) {
+        Stop();
+        engine = circuit;
+        // 以电路中已经设置的输入值为起点，之后由 SetInput 更新
+        inputs.resize(engine.GetInputCount());
+        appliedInputs.resize(engine.GetInputCount());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            inputs[i] = engine.GetInput(i);
+            appliedInputs[i] = inputs[i] ? 1 : 0;
+        }
+        mode = startMode;
+        stopping = false;
+        controlDirty = true;
+        Publish();
+        worker = std::thread(&SimulationThread::WorkerLoop, this);
+    }
+
+    void Stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        worker.join();
+    }
+
+    bool IsRunning() const { return worker.joinable(); }
+
+    void SetMode(Mode newMode) {
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            mode = newMode;
+            controlDirty = true;
+        }
+        wakeup.notify_all();
+    }
+
+    Mode GetMode() {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        return mode;
+    }
+
+    // 实时模式下每秒真实时间对应的仿真秒数
+    void SetSpeed(double simulatedSecondsPerSecond) {
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            speed = simulatedSecondsPerSecond > 0 ? simulatedSecondsPerSecond : 1.0;
+            controlDirty = true;
+        }
+        wakeup.notify_all();
+    }
+
+    // 设置输入元件的值（按网表中输入元件的顺序），下一批推进前生效
+    void SetInput(size_t input, bool value) {
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            if (input >= inputs.size() || inputs[input] == value) return;
+            inputs[input] = value;
+            controlDirty = true;
+        }
+        wakeup.notify_all();
+    }
+
+    // 取走最新快照；自上次取走后没有新快照时返回 false。snapshot 原有的缓冲留给工作线程复用
+    bool TakeSnapshot(SequentialSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        if (snapshotVersion == takenVersion) return false;
+        std::swap(snapshot, published);
+        takenVersion = snapshotVersion;
+        return true;
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // 把仿真时间换算成真实时间点
+    static Clock::time_point WallTime(Clock::time_point wallStart, uint64_t simStart, uint64_t simTime, double speed) {
+        double ns = static_cast<double>(simTime - simStart) / speed;
+        return wallStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::nano>(ns));
+    }
+
+    void Publish() {
+        engine.Capture(staging);
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        std::swap(staging, published);
+        snapshotVersion++;
+    }
+
+    void WorkerLoop() {
+        const auto interval = std::chrono::milliseconds(SNAPSHOT_INTERVAL_MS);
+        Clock::time_point wallStart = Clock::now();
+        Clock::time_point lastPublish = wallStart;
+        uint64_t simStart = engine.GetTime();
+        bool changedSincePublish = false;
+
+        std::unique_lock<std::mutex> lock(controlMutex);
+        while (!stopping) {
+            Mode current = mode;
+            double currentSpeed = speed;
+            bool inputsChanged = false;
+            if (controlDirty) {
+                // 输入或模式变化：应用输入值，并以当前时刻重新对齐实时时钟
+                controlDirty = false;
+                for (size_t i = 0; i < inputs.size(); ++i) {
+                    int value = inputs[i] ? 1 : 0;
+                    if (appliedInputs[i] == value) continue;
+                    appliedInputs[i] = value;
+                    engine.SetInput(i, inputs[i]);
+                    inputsChanged = true;
+                }
+                wallStart = Clock::now();
+                simStart = engine.GetTime();
+            }
+            lock.unlock();
+
+            if (inputsChanged) {
+                engine.Settle();
+                changedSincePublish = true;
+            }
+            if (current == MODE_FAST) {
+                for (int i = 0; i < FAST_BATCH && engine.StepToNextEdge(); ++i) changedSincePublish = true;
+            }
+            else if (current == MODE_REALTIME) {
+                // 推进到与当前真实时间对应的仿真时刻；一个发布间隔内追不上时放弃落后的部分
+                Clock::time_point now = Clock::now();
+                uint64_t target = simStart + static_cast<uint64_t>(
+                    std::chrono::duration<double, std::nano>(now - wallStart).count() * currentSpeed);
+                while (engine.GetNextEdgeTime() <= target) {
+                    engine.StepToNextEdge();
+                    changedSincePublish = true;
+                    if (Clock::now() - now >= interval) {
+                        wallStart = Clock::now();
+                        simStart = engine.GetTime();
+                        break;
+                    }
+                }
+            }
+
+            Clock::time_point now = Clock::now();
+            if (changedSincePublish && now - lastPublish >= interval) {
+                Publish();
+                lastPublish = now;
+                changedSincePublish = false;
+            }
+
+            lock.lock();
+            if (stopping || controlDirty) continue;
+            if (current == MODE_PAUSED || (current == MODE_FAST && engine.GetNextEdgeTime() == SequentialCircuit::NO_EDGE)) {
+                // 没有可推进的内容：发布剩余变化后等待命令
+                if (changedSincePublish) {
+                    lock.unlock();
+                    Publish();
+                    lastPublish = Clock::now();
+                    changedSincePublish = false;
+                    lock.lock();
+                    if (stopping || controlDirty) continue;
+                }
+                wakeup.wait(lock, [this] { return stopping || controlDirty; });
+            }
+            else if (current == MODE_REALTIME) {
+                // 睡到下一个时钟边沿或下一次快照，命令到达时提前唤醒
+                Clock::time_point deadline = Clock::time_point::max();
+                if (changedSincePublish) deadline = lastPublish + interval;
+                uint64_t nextEdge = engine.GetNextEdgeTime();
+                if (nextEdge != SequentialCircuit::NO_EDGE) {
+                    deadline = std::min(deadline, WallTime(wallStart, simStart, nextEdge, currentSpeed));
+                }
+                if (deadline == Clock::time_point::max()) {
+                    wakeup.wait(lock, [this] { return stopping || controlDirty; });
+                }
+                else {
+                    wakeup.wait_until(lock, deadline, [this] { return stopping || controlDirty; });
+                }
+            }
+        }
+        lock.unlock();
+        Publish();
+    }
+
+    SequentialCircuit engine;            // 工作线程独占的仿真电路
+    std::thread worker;
+
+    std::mutex controlMutex;             // 保护以下控制状态
+    std::condition_variable wakeup;
+    Mode mode;
+    double speed;
+    bool stopping;
+    bool controlDirty;                   // 输入或模式有待工作线程处理
+    std::vector<bool> inputs;            // 界面设置的输入值
+    std::vector<int> appliedInputs;      // 已写入仿真电路的输入值（工作线程使用，-1 表示尚未写入）
+
+    std::mutex snapshotMutex;            // 保护以下快照状态
+    SequentialSnapshot published;        // 最新发布的快照
+    uint64_t snapshotVersion;
+    uint64_t takenVersion;
+    SequentialSnapshot staging;          // 工作线程填写的下一份快照
+};
+
+#endif
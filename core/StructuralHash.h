@@ -0,0 +1,47 @@
+#pragma once
+#ifndef STRUCTURALHASH_H
+#define STRUCTURALHASH_H
+
+#include <cstdint>
+#include <string>
+#include "Netlist.h"
+
+// 电路的结构哈希：只包含元件类型、引脚连接的线网和时钟参数，
+// 不含坐标、输入值和触发器的当前状态。移动元件或仿真不会改变哈希，增删元件和连线会
+class StructuralHash {
+public:
+    static uint64_t Compute(const Netlist& netlist) {
+        const auto& elements = netlist.GetElements();
+        uint64_t hash = Mix(0, static_cast<uint64_t>(elements.size()));
+        for (const NetlistElement& element : elements) {
+            hash = Mix(hash, static_cast<uint64_t>(element.type));
+            hash = Mix(hash, element.inputs.size());
+            for (int net : element.inputs) hash = Mix(hash, static_cast<uint64_t>(net));
+            hash = Mix(hash, element.outputs.size());
+            for (int net : element.outputs) hash = Mix(hash, static_cast<uint64_t>(net));
+            if (element.type == TYPE_CLOCK) hash = Mix(hash, HashString(element.attributes));
+        }
+        return hash;
+    }
+
+    // splitmix64 的混合函数；也用于把其他参数（例如被观察的输出）并入缓存键
+    static uint64_t Mix(uint64_t hash, uint64_t value) {
+        uint64_t z = hash + 0x9E3779B97F4A7C15ull + value;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    // FNV-1a
+    static uint64_t HashString(const std::string& text) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+};
+
+#endif
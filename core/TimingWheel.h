@@ -0,0 +1,158 @@
+#pragma once
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 分层时间轮：64 位时间（纳秒）按字节分成 8 层，每层 256 个槽。
+// 事件放在与当前时间最高的不同字节所在的层，取下一个事件时只需找到最低层的第一个非空槽，
+// 高层的槽在当前时间推进到其范围时才逐层下放。空闲的时间段被直接跳过，
+// 取一个事件的代价与时间跨度无关（最多 8 层各下放一次）
+class TimingWheel {
+public:
+    enum : int { LEVELS = 8, SLOT_BITS = 8, SLOTS = 1 << SLOT_BITS };
+    enum : uint64_t { NO_EVENT = ~uint64_t(0) };
+
+    TimingWheel() { Reset(0); }
+
+    // 清空所有事件并把当前时间设为 start
+    void Reset(uint64_t start) {
+        now = start;
+        count = 0;
+        heads.assign(LEVELS * SLOTS, -1);
+        for (auto& word : occupied) word = 0;
+        nextEvent.clear();
+        dueTime.clear();
+    }
+
+    // 在 time（不早于当前时间）调度事件 id（非负整数，同一 id 同时只能调度一次）
+    void Schedule(int id, uint64_t time) {
+        if (id >= static_cast<int>(nextEvent.size())) {
+            nextEvent.resize(id + 1, -1);
+            dueTime.resize(id + 1, 0);
+        }
+        dueTime[id] = time < now ? now : time;
+        Insert(id);
+        count++;
+    }
+
+    // 推进到最早的事件时刻，把该时刻到期的全部事件追加到 due；没有事件时返回 false
+    bool PopNext(uint64_t& time, std::vector<int>& due) {
+        if (count == 0) return false;
+        for (int level = 0; level < LEVELS;) {
+            int slot = FindSlot(level);
+            if (slot < 0) {
+                level++;
+                continue;
+            }
+            if (level == 0) {
+                // 第 0 层的事件与当前时间只有最低字节不同，同一槽内的事件时刻相同
+                now = (now & ~uint64_t(SLOTS - 1)) | static_cast<uint64_t>(slot);
+                time = now;
+                for (int id = TakeSlot(0, slot); id >= 0;) {
+                    int next = nextEvent[id];
+                    due.push_back(id);
+                    count--;
+                    id = next;
+                }
+                return true;
+            }
+
+            // 把当前时间推进到该槽的起点，槽内事件下放到更低的层
+            int shift = level * SLOT_BITS;
+            uint64_t above = shift + SLOT_BITS >= 64 ? 0 : (now >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+            now = above | (static_cast<uint64_t>(slot) << shift);
+            for (int id = TakeSlot(level, slot); id >= 0;) {
+                int next = nextEvent[id];
+                Insert(id);
+                id = next;
+            }
+            level = 0;
+        }
+        return false;
+    }
+
+    // 最早的事件时刻（不推进时间）；没有事件时返回 NO_EVENT
+    uint64_t PeekNext() const {
+        if (count == 0) return NO_EVENT;
+        for (int level = 0; level < LEVELS; ++level) {
+            int slot = FindSlot(level);
+            if (slot < 0) continue;
+            uint64_t earliest = NO_EVENT;
+            for (int id = heads[level * SLOTS + slot]; id >= 0; id = nextEvent[id]) {
+                if (dueTime[id] < earliest) earliest = dueTime[id];
+            }
+            return earliest;
+        }
+        return NO_EVENT;
+    }
+
+    uint64_t GetTime() const { return now; }
+    size_t GetCount() const { return count; }
+    bool IsEmpty() const { return count == 0; }
+
+private:
+    // 事件所在的层：与当前时间最高的不同字节
+    int LevelOf(uint64_t time) const {
+        uint64_t diff = time ^ now;
+        int level = 0;
+        while (level + 1 < LEVELS && (diff >> ((level + 1) * SLOT_BITS)) != 0) level++;
+        return level;
+    }
+
+    void Insert(int id) {
+        int level = LevelOf(dueTime[id]);
+        int slot = static_cast<int>((dueTime[id] >> (level * SLOT_BITS)) & (SLOTS - 1));
+        int& head = heads[level * SLOTS + slot];
+        nextEvent[id] = head;
+        head = id;
+        occupied[level * WORDS_PER_LEVEL + slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+
+    // 取出整个槽的事件链表
+    int TakeSlot(int level, int slot) {
+        int& head = heads[level * SLOTS + slot];
+        int first = head;
+        head = -1;
+        occupied[level * WORDS_PER_LEVEL + slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        return first;
+    }
+
+    // 该层从当前时间所在位置起的第一个非空槽（第 0 层含当前槽，更高层从下一个槽开始）
+    int FindSlot(int level) const {
+        int current = static_cast<int>((now >> (level * SLOT_BITS)) & (SLOTS - 1));
+        int start = level == 0 ? current : current + 1;
+        for (int word = start / 64; word < WORDS_PER_LEVEL; ++word) {
+            uint64_t bits = occupied[level * WORDS_PER_LEVEL + word];
+            if (word == start / 64) bits &= ~uint64_t(0) << (start % 64);
+            if (bits) return word * 64 + CountTrailingZeros(bits);
+        }
+        return -1;
+    }
+
+    static int CountTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#else
+        int n = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    enum : int { WORDS_PER_LEVEL = SLOTS / 64 };
+
+    uint64_t now;                                  // 当前时间
+    size_t count;                                  // 已调度的事件数
+    std::vector<int> heads;                        // 每层每槽的事件链表头（-1 表示空）
+    uint64_t occupied[LEVELS * (SLOTS / 64)];      // 非空槽位图
+    std::vector<int> nextEvent;                    // 事件链表的下一个事件
+    std::vector<uint64_t> dueTime;                 // 事件时刻
+};
+
+#endif
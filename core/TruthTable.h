@@ -0,0 +1,125 @@
+#pragma once
+#ifndef TRUTHTABLE_H
+#define TRUTHTABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "CompiledCircuit.h"
+#include "VectorizedCircuit.h"
+
+// 打包的真值表：每个输出一列，每行一位
+struct TruthTableData {
+    static const int MAX_INPUTS = 30;  // 2^30 行，每个输出 128MB；更多输入用 BDD 分析
+
+    int numInputs = 0;
+    int numOutputs = 0;
+    uint64_t rows = 0;
+    size_t wordsPerOutput = 0;
+    std::vector<uint64_t> bits;  // 第 o 个输出的第 w 个字位于 bits[o * wordsPerOutput + w]
+
+    // 按输入输出数量分配存储并清零
+    void Resize(int inputs, int outputs) {
+        numInputs = inputs;
+        numOutputs = outputs;
+        rows = uint64_t(1) << numInputs;
+        wordsPerOutput = static_cast<size_t>((rows + 63) / 64);
+        bits.assign(wordsPerOutput * numOutputs, 0);
+    }
+
+    // 第 row 行中第 input 个输入的值（Input 1 为最高位）
+    bool GetInput(uint64_t row, int input) const {
+        return ((row >> (numInputs - input - 1)) & 1) != 0;
+    }
+
+    // 第 row 行中第 output 个输出的值
+    bool GetOutput(uint64_t row, int output) const {
+        return ((bits[output * wordsPerOutput + (row >> 6)] >> (row & 63)) & 1) != 0;
+    }
+};
+
+// 64 路位并行真值表生成：每个线网用一个 uint64_t 同时表示 64 行
+class BitParallelTruthTable {
+public:
+    // 分配存储
+    static void Prepare(const CompiledCircuit& circuit, TruthTableData& table) {
+        table.Resize(static_cast<int>(circuit.GetInputSlots().size()),
+            static_cast<int>(circuit.GetOutputSlots().size()));
+    }
+
+    // 计算 [firstWord, lastWord) 范围内的行（每个字 64 行），values 为调用者提供的线网缓冲
+    static void GenerateRange(const CompiledCircuit& circuit, TruthTableData& table,
+        size_t firstWord, size_t lastWord, std::vector<uint64_t>& values) {
+        const auto& inputSlots = circuit.GetInputSlots();
+        const auto& outputSlots = circuit.GetOutputSlots();
+        values.assign(circuit.GetSlotCount(), 0);
+
+        const uint64_t validMask = table.rows >= 64 ? ~uint64_t(0) : ((uint64_t(1) << table.rows) - 1);
+        for (size_t word = firstWord; word < lastWord; ++word) {
+            uint64_t baseRow = uint64_t(word) << 6;
+            for (int i = 0; i < table.numInputs; ++i) {
+                int bit = table.numInputs - i - 1;
+                values[inputSlots[i]] = bit < 6 ? LowBitPattern(bit)
+                    : (((baseRow >> bit) & 1) ? ~uint64_t(0) : 0);
+            }
+            circuit.Evaluate(values.data());
+            for (int o = 0; o < table.numOutputs; ++o) {
+                table.bits[o * table.wordsPerOutput + word] = values[outputSlots[o]] & validMask;
+            }
+        }
+    }
+
+    // 用向量化内核计算 [firstWord, lastWord) 范围内的行，每次求值覆盖 blockWords 个字
+    static void GenerateRange(VectorizedCircuit& vectorized, TruthTableData& table,
+        size_t firstWord, size_t lastWord) {
+        const size_t blockWords = vectorized.GetBlockWords();
+        for (size_t block = firstWord; block < lastWord; block += blockWords) {
+            size_t count = std::min(blockWords, lastWord - block);
+            for (int i = 0; i < table.numInputs; ++i) {
+                int bit = table.numInputs - i - 1;
+                uint64_t* words = vectorized.InputWords(i);
+                for (size_t k = 0; k < blockWords; ++k) {
+                    uint64_t baseRow = uint64_t(block + k) << 6;
+                    words[k] = bit < 6 ? LowBitPattern(bit)
+                        : (((baseRow >> bit) & 1) ? ~uint64_t(0) : 0);
+                }
+            }
+            vectorized.Evaluate();
+            for (int o = 0; o < table.numOutputs; ++o) {
+                std::copy(vectorized.OutputWords(o), vectorized.OutputWords(o) + count,
+                    table.bits.begin() + o * table.wordsPerOutput + block);
+            }
+        }
+    }
+
+    // 向量化求值时每个线网的字数：让整个线网存储留在二级缓存内
+    static size_t ChooseBlockWords(const CompiledCircuit& circuit) {
+        const size_t cacheWords = 32 * 1024;  // 256KB
+        size_t words = cacheWords / std::max<size_t>(circuit.GetSlotCount(), 1);
+        return std::max<size_t>(VectorizedCircuit::WORDS_PER_VECTOR, std::min<size_t>(words, 64));
+    }
+
+    // 生成完整真值表（不足一个向量时直接用 64 位标量求值）
+    static void Generate(const CompiledCircuit& circuit, TruthTableData& table) {
+        Prepare(circuit, table);
+        if (table.wordsPerOutput < VectorizedCircuit::WORDS_PER_VECTOR) {
+            std::vector<uint64_t> values;
+            GenerateRange(circuit, table, 0, table.wordsPerOutput, values);
+            return;
+        }
+        VectorizedCircuit vectorized;
+        vectorized.Build(circuit, std::min(ChooseBlockWords(circuit), table.wordsPerOutput));
+        GenerateRange(vectorized, table, 0, table.wordsPerOutput);
+    }
+
+private:
+    // 行号低 6 位在 64 行内的取值模式：第 k 位每 2^k 行翻转一次
+    static uint64_t LowBitPattern(int bit) {
+        static const uint64_t patterns[6] = {
+            0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+            0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+        };
+        return patterns[bit];
+    }
+};
+
+#endif
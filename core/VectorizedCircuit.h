@@ -0,0 +1,219 @@
+#pragma once
+#ifndef VECTORIZEDCIRCUIT_H
+#define VECTORIZEDCIRCUIT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "CompiledCircuit.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define EDA_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define EDA_TARGET_AVX2
+#else
+#define EDA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// 向量化门级求值：同层同类型的门分为一组，按组批量求值，
+// 每个线网占 blockWords 个连续的 uint64_t（每一位是一路独立激励）
+class VectorizedCircuit {
+public:
+    // 求值内核
+    enum Kernel {
+        KERNEL_SCALAR,  // 每次 64 位
+        KERNEL_SSE2,    // 每次 128 位
+        KERNEL_AVX2     // 每次 256 位
+    };
+
+    // 每个线网最少占用的字数（一个 256 位向量）
+    enum : size_t { WORDS_PER_VECTOR = 4 };
+
+    VectorizedCircuit() : blockWords(0), kernel(DetectKernel()) {}
+
+    // 从编译好的电路构建分组指令；blockWords 会向上取整到 4 的倍数
+    bool Build(const CompiledCircuit& circuit, size_t words) {
+        groups.clear();
+        in0.clear();
+        in1.clear();
+        out.clear();
+        if (!circuit.IsValid()) return false;
+
+        blockWords = (std::max<size_t>(words, 1) + WORDS_PER_VECTOR - 1) / WORDS_PER_VECTOR * WORDS_PER_VECTOR;
+        inputSlots = circuit.GetInputSlots();
+        outputSlots = circuit.GetOutputSlots();
+        values.assign(static_cast<size_t>(circuit.GetSlotCount()) * blockWords, 0);
+
+        // 每层内按操作码分组，组内的操作数地址连续存放（结构数组）
+        const auto& program = circuit.GetProgram();
+        const auto& levelStart = circuit.GetLevelStart();
+        for (uint32_t level = 0; level < circuit.GetLevelCount(); ++level) {
+            for (uint8_t op = GATE_AND; op <= GATE_NOR; ++op) {
+                Group group{ op, static_cast<uint32_t>(out.size()), 0 };
+                for (uint32_t i = levelStart[level]; i < levelStart[level + 1]; ++i) {
+                    const GateInstruction& instr = program[i];
+                    if (instr.opcode != op) continue;
+                    in0.push_back(instr.in0 * static_cast<uint32_t>(blockWords));
+                    in1.push_back(instr.in1 * static_cast<uint32_t>(blockWords));
+                    out.push_back(instr.out * static_cast<uint32_t>(blockWords));
+                }
+                group.end = static_cast<uint32_t>(out.size());
+                if (group.end > group.begin) groups.push_back(group);
+            }
+        }
+        return true;
+    }
+
+    size_t GetBlockWords() const { return blockWords; }
+    size_t GetGroupCount() const { return groups.size(); }
+    const std::vector<uint32_t>& GetInputSlots() const { return inputSlots; }
+    const std::vector<uint32_t>& GetOutputSlots() const { return outputSlots; }
+
+    // 线网的激励/结果存储（blockWords 个字）
+    uint64_t* NetWords(uint32_t slot) { return &values[static_cast<size_t>(slot) * blockWords]; }
+    const uint64_t* NetWords(uint32_t slot) const { return &values[static_cast<size_t>(slot) * blockWords]; }
+    uint64_t* InputWords(size_t input) { return NetWords(inputSlots[input]); }
+    const uint64_t* OutputWords(size_t output) const { return NetWords(outputSlots[output]); }
+
+    Kernel GetKernel() const { return kernel; }
+    void SetKernel(Kernel k) { kernel = (k <= DetectKernel()) ? k : DetectKernel(); }
+
+    static const char* GetKernelName(Kernel k) {
+        switch (k) {
+        case KERNEL_AVX2: return "AVX2";
+        case KERNEL_SSE2: return "SSE2";
+        default: return "scalar";
+        }
+    }
+
+    // 对当前激励求值一次
+    void Evaluate() {
+        std::fill(values.begin(), values.begin() + blockWords, 0);  // 常量0线网
+        uint64_t* base = values.data();
+        for (const Group& group : groups) {
+            switch (kernel) {
+#ifdef EDA_SIMD_X86
+            case KERNEL_AVX2: EvaluateGroupAVX2(base, group); break;
+            case KERNEL_SSE2: EvaluateGroupSSE2(base, group); break;
+#endif
+            default: EvaluateGroupScalar(base, group); break;
+            }
+        }
+    }
+
+    // 运行时检测 CPU 支持的最佳内核
+    static Kernel DetectKernel() {
+#ifdef EDA_SIMD_X86
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+                __cpuidex(info, 7, 0);
+                if (info[1] & (1 << 5)) return KERNEL_AVX2;
+            }
+        }
+        return KERNEL_SSE2;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+        if (__builtin_cpu_supports("sse2")) return KERNEL_SSE2;
+        return KERNEL_SCALAR;
+#endif
+#else
+        return KERNEL_SCALAR;
+#endif
+    }
+
+private:
+    // 同层同操作码的一组门：[begin, end) 为 in0/in1/out 中的下标
+    struct Group {
+        uint8_t opcode;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // 对一组门逐向量求值；step 为每个向量包含的字数，读写和运算由调用者提供
+    template <typename Load, typename Store, typename Op>
+    void EvaluateGroup(uint64_t* base, const Group& group, size_t step, Load load, Store store, Op op) const {
+        for (uint32_t g = group.begin; g < group.end; ++g) {
+            const uint64_t* a = base + in0[g];
+            const uint64_t* b = base + in1[g];
+            uint64_t* r = base + out[g];
+            for (size_t k = 0; k < blockWords; k += step) {
+                store(r + k, op(load(a + k), load(b + k)));
+            }
+        }
+    }
+
+    void EvaluateGroupScalar(uint64_t* base, const Group& group) const {
+        auto load = [](const uint64_t* p) { return *p; };
+        auto store = [](uint64_t* p, uint64_t v) { *p = v; };
+        switch (group.opcode) {
+        case GATE_AND: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t b) { return a & b; }); break;
+        case GATE_OR: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t b) { return a | b; }); break;
+        case GATE_NOT: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t) { return ~a; }); break;
+        case GATE_XOR: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t b) { return a ^ b; }); break;
+        case GATE_NAND: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t b) { return ~(a & b); }); break;
+        default: EvaluateGroup(base, group, 1, load, store, [](uint64_t a, uint64_t b) { return ~(a | b); }); break;
+        }
+    }
+
+#ifdef EDA_SIMD_X86
+    void EvaluateGroupSSE2(uint64_t* base, const Group& group) const {
+        auto load = [](const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+        auto store = [](uint64_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); };
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (group.opcode) {
+        case GATE_AND: EvaluateGroup(base, group, 2, load, store, [](__m128i a, __m128i b) { return _mm_and_si128(a, b); }); break;
+        case GATE_OR: EvaluateGroup(base, group, 2, load, store, [](__m128i a, __m128i b) { return _mm_or_si128(a, b); }); break;
+        case GATE_NOT: EvaluateGroup(base, group, 2, load, store, [ones](__m128i a, __m128i) { return _mm_xor_si128(a, ones); }); break;
+        case GATE_XOR: EvaluateGroup(base, group, 2, load, store, [](__m128i a, __m128i b) { return _mm_xor_si128(a, b); }); break;
+        case GATE_NAND: EvaluateGroup(base, group, 2, load, store, [ones](__m128i a, __m128i b) { return _mm_xor_si128(_mm_and_si128(a, b), ones); }); break;
+        default: EvaluateGroup(base, group, 2, load, store, [ones](__m128i a, __m128i b) { return _mm_xor_si128(_mm_or_si128(a, b), ones); }); break;
+        }
+    }
+
+    // AVX2 内核不使用 lambda，以保证整个循环都在 avx2 目标属性下编译
+    EDA_TARGET_AVX2 void EvaluateGroupAVX2(uint64_t* base, const Group& group) const {
+        const __m256i ones = _mm256_set1_epi32(-1);
+        for (uint32_t g = group.begin; g < group.end; ++g) {
+            const __m256i* a = reinterpret_cast<const __m256i*>(base + in0[g]);
+            const __m256i* b = reinterpret_cast<const __m256i*>(base + in1[g]);
+            __m256i* r = reinterpret_cast<__m256i*>(base + out[g]);
+            for (size_t k = 0; k < blockWords / WORDS_PER_VECTOR; ++k) {
+                __m256i x = _mm256_loadu_si256(a + k);
+                __m256i y = _mm256_loadu_si256(b + k);
+                __m256i v;
+                switch (group.opcode) {
+                case GATE_AND: v = _mm256_and_si256(x, y); break;
+                case GATE_OR: v = _mm256_or_si256(x, y); break;
+                case GATE_NOT: v = _mm256_xor_si256(x, ones); break;
+                case GATE_XOR: v = _mm256_xor_si256(x, y); break;
+                case GATE_NAND: v = _mm256_xor_si256(_mm256_and_si256(x, y), ones); break;
+                default: v = _mm256_xor_si256(_mm256_or_si256(x, y), ones); break;
+                }
+                _mm256_storeu_si256(r + k, v);
+            }
+        }
+    }
+#endif
+
+    std::vector<Group> groups;         // 按层、按操作码排列的门组
+    std::vector<uint32_t> in0;         // 各门第一个输入在线网存储中的偏移
+    std::vector<uint32_t> in1;         // 各门第二个输入在线网存储中的偏移
+    std::vector<uint32_t> out;         // 各门输出在线网存储中的偏移
+    std::vector<uint32_t> inputSlots;  // 输入元件驱动的线网
+    std::vector<uint32_t> outputSlots; // 输出元件读取的线网
+    std::vector<uint64_t> values;      // 线网值存储：slot * blockWords + k
+    size_t blockWords;                 // 每个线网的字数
+    Kernel kernel;                     // 当前使用的内核
+};
+
+#endif
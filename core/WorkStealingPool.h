@@ -0,0 +1,167 @@
+#pragma once
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池：每个工作线程有自己的任务队列，从队尾取自己的任务，
+// 空闲时从其他队列的队头窃取。ParallelFor 在所有分块完成后才返回，可作为层间屏障
+class WorkStealingPool {
+public:
+    // 空闲工作线程进入休眠前的自旋次数（层与层之间的间隔通常很短）
+    static const int SPIN_BEFORE_SLEEP = 4000;
+
+    explicit WorkStealingPool(unsigned workerCount = DefaultWorkerCount()) : stopping(false), queuedTasks(0) {
+        for (unsigned i = 0; i < workerCount; ++i) queues.emplace_back(new WorkQueue());
+        for (unsigned i = 0; i < workerCount; ++i) threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 默认工作线程数：调用线程也参与计算，因此比硬件线程数少一个
+    static unsigned DefaultWorkerCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 0;
+    }
+
+    unsigned GetWorkerCount() const { return static_cast<unsigned>(threads.size()); }
+
+    // 把 [0, count) 按 grain 分块并行执行 fn(begin, end)；调用线程同样参与执行，返回时全部分块已完成
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t grain, Fn& fn) {
+        if (grain == 0) grain = 1;
+        if (threads.empty() || count <= grain) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        Batch batch;
+        batch.invoke = &InvokeRange<Fn>;
+        batch.context = &fn;
+        size_t chunks = (count + grain - 1) / grain;
+        batch.remaining.store(chunks, std::memory_order_relaxed);
+
+        // 先登记任务数再入队，保证取走任务时计数不会出现负值
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queuedTasks.fetch_add(chunks, std::memory_order_release);
+        }
+        // 按轮转方式分配到各工作线程的队列
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t begin = c * grain;
+            size_t end = std::min(count, begin + grain);
+            WorkQueue& queue = *queues[c % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(Task{ &batch, begin, end });
+        }
+        wakeup.notify_all();
+
+        // 调用线程窃取任务直到本批次全部完成
+        Task task;
+        while (batch.remaining.load(std::memory_order_acquire) != 0) {
+            if (TrySteal(task, 0)) Run(task);
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    // 一次 ParallelFor 调用
+    struct Batch {
+        void (*invoke)(void* context, size_t begin, size_t end);
+        void* context;
+        std::atomic<size_t> remaining;  // 未完成的分块数
+    };
+
+    struct Task {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    template <typename Fn>
+    static void InvokeRange(void* context, size_t begin, size_t end) {
+        (*static_cast<Fn*>(context))(begin, end);
+    }
+
+    static void Run(const Task& task) {
+        task.batch->invoke(task.batch->context, task.begin, task.end);
+        task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // 从自己的队尾取任务
+    bool TryPop(Task& task, size_t self) {
+        WorkQueue& queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 从其他队列的队头窃取任务
+    bool TrySteal(Task& task, size_t start) {
+        for (size_t k = 0; k < queues.size(); ++k) {
+            WorkQueue& queue = *queues[(start + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t self) {
+        Task task;
+        int idleSpins = 0;
+        for (;;) {
+            if (TryPop(task, self) || TrySteal(task, self + 1)) {
+                Run(task);
+                idleSpins = 0;
+                continue;
+            }
+            if (++idleSpins < SPIN_BEFORE_SLEEP) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeup.wait(lock, [this] { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+            if (stopping) return;
+            idleSpins = 0;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;  // 每个工作线程一个任务队列
+    std::vector<std::thread> threads;                // 工作线程
+    std::mutex sleepMutex;                           // 休眠与唤醒
+    std::condition_variable wakeup;
+    bool stopping;                                   // 析构时通知线程退出
+    std::atomic<size_t> queuedTasks;                 // 所有队列中尚未取走的任务数
+};
+
+#endif
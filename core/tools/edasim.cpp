@@ -0,0 +1,369 @@
+// 命令行仿真工具：不依赖图形界面，加载电路文件后求值或生成真值表
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "CircuitFile.h"
+#include "CircuitBdd.h"
+#include "CompiledCircuit.h"
+#include "EquivalenceChecker.h"
+#include "IncrementalEvaluator.h"
+#include "LogicMinimizer.h"
+#include "ModelExporter.h"
+#include "ParallelEvaluator.h"
+#include "SequentialCircuit.h"
+#include "ParallelTruthTable.h"
+
+// 逐个输出最小化并打印与或表达式；给出 synthesizeFile 时写出两级电路，并核对其真值表与原电路一致
+static int MinimizeOutputs(const Netlist& netlist, const TruthTableData& table, const std::string& synthesizeFile) {
+    if (table.numInputs > LogicMinimizer::MAX_INPUTS) {
+        std::fprintf(stderr, "edasim: too many inputs to minimize (%d)\n", table.numInputs);
+        return 1;
+    }
+    std::vector<std::vector<Cube>> covers(table.numOutputs);
+    size_t cubes = 0, literals = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int o = 0; o < table.numOutputs; ++o) {
+        LogicMinimizer::Minimize(table, o, covers[o]);
+        cubes += covers[o].size();
+        literals += LogicMinimizer::CountLiterals(covers[o]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int o = 0; o < table.numOutputs; ++o) {
+        std::printf("Output %d = %s\n", o + 1, LogicMinimizer::Format(covers[o], table.numInputs).c_str());
+    }
+    std::printf("%zu products, %zu literals, %.3f s\n", cubes, literals, seconds);
+    if (synthesizeFile.empty()) return 0;
+
+    Netlist result;
+    LogicMinimizer::Synthesize(netlist, covers, result);
+    CompiledCircuit circuit;
+    TruthTableData check;
+    if (circuit.Compile(result)) BitParallelTruthTable::Generate(circuit, check);
+    if (check.bits != table.bits) {
+        std::fprintf(stderr, "edasim: synthesized circuit does not match the truth table\n");
+        return 1;
+    }
+    std::string error;
+    if (!CircuitFile::Save(synthesizeFile, result, &error)) {
+        std::fprintf(stderr, "edasim: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("wrote %s, %zu elements\n", synthesizeFile.c_str(), result.GetElements().size());
+    return 0;
+}
+
+// 逐个翻转随机输入并增量求值（与画布上点击输入相同），与整体求值的耗时和结果比较
+static int BenchmarkToggles(const CompiledCircuit& circuit, int toggles) {
+    const auto& inputSlots = circuit.GetInputSlots();
+    if (inputSlots.empty()) {
+        std::fprintf(stderr, "edasim: circuit has no inputs\n");
+        return 1;
+    }
+    std::vector<uint8_t> values(circuit.GetSlotCount(), 0), reference;
+    circuit.Evaluate(values.data());
+    IncrementalEvaluator incremental;
+    incremental.Prepare(circuit);
+
+    std::vector<uint32_t> changed;
+    double incrementalSeconds = 0, fullSeconds = 0;
+    size_t evaluated = 0, changedSlots = 0;
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (int t = 0; t < toggles; ++t) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        uint32_t slot = inputSlots[seed % inputSlots.size()];
+        values[slot] ^= 0xFF;
+        changed.assign(1, slot);
+        auto start = std::chrono::steady_clock::now();
+        incremental.Propagate(circuit, values.data(), changed);
+        auto middle = std::chrono::steady_clock::now();
+        reference = values;
+        circuit.Evaluate(reference.data());
+        auto end = std::chrono::steady_clock::now();
+        incrementalSeconds += std::chrono::duration<double>(middle - start).count();
+        fullSeconds += std::chrono::duration<double>(end - middle).count();
+        evaluated += incremental.GetEvaluatedCount();
+        changedSlots += changed.size() - 1;
+        if (reference != values) {
+            std::fprintf(stderr, "edasim: incremental evaluation diverged after %d toggles\n", t + 1);
+            return 1;
+        }
+    }
+    std::printf("%d toggles: incremental %.2f us, %.1f gates evaluated, %.1f nets changed; full %.2f us, %zu gates\n",
+        toggles, incrementalSeconds / toggles * 1e6, static_cast<double>(evaluated) / toggles,
+        static_cast<double>(changedSlots) / toggles, fullSeconds / toggles * 1e6, circuit.GetProgram().size());
+    return 0;
+}
+
+static int Usage() {
+    std::fprintf(stderr,
+        "usage: edasim <circuit.txt> [options]\n"
+        "  --inputs BITS     evaluate once with the given input values (e.g. 0110, Input 1 first)\n"
+        "  --truth-table     print the full truth table\n"
+        "  --bench N         evaluate the truth table N times and report throughput\n"
+        "  --threads T       with --bench: evaluate 64 random patterns N times on T worker threads\n"
+        "  --jobs J          generate the truth table on J threads (0 = all hardware threads)\n"
+        "  --cycles N        run N clock steps of a sequential circuit, print the outputs and throughput\n"
+        "  --seconds S       advance a sequential circuit by S simulated seconds (clock frequencies in Hz)\n"
+        "  --export NAME     write a standalone C++ model NAME.h, NAME.cpp and driver NAME_main.cpp\n"
+        "  --bdd             build a BDD per output and report constants, satisfiability and a witness\n"
+        "  --minimize        print a minimized sum of products per output\n"
+        "  --synthesize FILE with --minimize: write the minimized two-level circuit to FILE\n"
+        "  --equiv FILE      prove the circuit equivalent to FILE or print a counterexample\n"
+        "  --save FILE       write the circuit to FILE (binary format if FILE ends in .circb) and exit\n"
+        "  --toggles N       flip N random inputs one at a time, re-evaluating only the affected gates\n"
+        "  --load-stats      report the size of the circuit file and how fast it was parsed\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return Usage();
+
+    std::string inputBits;
+    bool printTable = false;
+    int benchRuns = 0;
+    int threads = -1;
+    int jobs = -1;
+    long long cycles = -1;
+    double simSeconds = -1;
+    std::string exportName;
+    bool analyzeBdd = false;
+    bool minimize = false;
+    std::string synthesizeFile;
+    std::string equivFile;
+    int toggles = 0;
+    std::string saveFile;
+    bool loadStats = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--inputs") == 0 && i + 1 < argc) inputBits = argv[++i];
+        else if (std::strcmp(argv[i], "--truth-table") == 0) printTable = true;
+        else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) benchRuns = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) jobs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) cycles = std::atoll(argv[++i]);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) simSeconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--export") == 0 && i + 1 < argc) exportName = argv[++i];
+        else if (std::strcmp(argv[i], "--bdd") == 0) analyzeBdd = true;
+        else if (std::strcmp(argv[i], "--minimize") == 0) minimize = true;
+        else if (std::strcmp(argv[i], "--synthesize") == 0 && i + 1 < argc) synthesizeFile = argv[++i];
+        else if (std::strcmp(argv[i], "--equiv") == 0 && i + 1 < argc) equivFile = argv[++i];
+        else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) saveFile = argv[++i];
+        else if (std::strcmp(argv[i], "--toggles") == 0 && i + 1 < argc) toggles = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--load-stats") == 0) loadStats = true;
+        else return Usage();
+    }
+
+    Netlist netlist;
+    std::string error;
+    CircuitTextReader::Stats stats;
+    if (!CircuitFile::Load(argv[1], netlist, &error, &stats)) {
+        std::fprintf(stderr, "edasim: %s\n", error.c_str());
+        return 1;
+    }
+    if (loadStats) {
+        std::printf("loaded %.1f MB, %llu lines, %.3f s, %.1f MB/s\n", stats.bytes / 1e6,
+            static_cast<unsigned long long>(stats.lines), stats.seconds, stats.GetMegabytesPerSecond());
+    }
+
+    if (!saveFile.empty()) {
+        if (!CircuitFile::Save(saveFile, netlist, &error)) {
+            std::fprintf(stderr, "edasim: %s\n", error.c_str());
+            return 1;
+        }
+        std::printf("wrote %s, %zu elements\n", saveFile.c_str(), netlist.GetElements().size());
+        return 0;
+    }
+
+    if (!exportName.empty()) {
+        if (!ModelExporter::Write(netlist, "", exportName, &error)) {
+            std::fprintf(stderr, "edasim: %s\n", error.c_str());
+            return 1;
+        }
+        std::string name = ModelExporter::SanitizeIdentifier(exportName);
+        std::printf("wrote %s.h, %s.cpp, %s_main.cpp\n", name.c_str(), name.c_str(), name.c_str());
+        return 0;
+    }
+
+    // 等价性检查：两个电路的输入输出按顺序对应
+    if (!equivFile.empty()) {
+        Netlist other;
+        if (!CircuitFile::Load(equivFile, other, &error)) {
+            std::fprintf(stderr, "edasim: %s\n", error.c_str());
+            return 1;
+        }
+        EquivalenceChecker checker;
+        auto start = std::chrono::steady_clock::now();
+        if (!checker.Check(netlist, other, &error)) {
+            std::fprintf(stderr, "edasim: %s\n", error.c_str());
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (checker.IsEquivalent()) {
+            std::printf("equivalent\n");
+        }
+        else {
+            std::string bits;
+            for (bool value : checker.GetCounterexample()) bits += value ? '1' : '0';
+            std::printf("not equivalent: inputs %s, outputs differ:", bits.c_str());
+            for (int o : checker.GetDifferingOutputs()) std::printf(" %d", o + 1);
+            std::printf("\n");
+        }
+        const SatSolver& solver = checker.GetSolver();
+        std::printf("%d variables, %llu conflicts, %llu decisions, %.3f s\n", solver.GetVariableCount(),
+            static_cast<unsigned long long>(solver.GetConflictCount()),
+            static_cast<unsigned long long>(solver.GetDecisionCount()), seconds);
+        return checker.IsEquivalent() ? 0 : 2;
+    }
+
+    // 符号分析：每个输出一个 BDD，不枚举真值表
+    if (analyzeBdd) {
+        CircuitBdd bdd;
+        auto start = std::chrono::steady_clock::now();
+        if (!bdd.Build(netlist, &error)) {
+            std::fprintf(stderr, "edasim: %s\n", error.c_str());
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const BddManager& manager = bdd.GetManager();
+        for (size_t o = 0; o < bdd.GetOutputCount(); ++o) {
+            BddNode f = bdd.GetOutput(o);
+            if (BddManager::IsConstant(f)) {
+                std::printf("Output %zu: constant %d\n", o + 1, f == BddManager::ONE ? 1 : 0);
+                continue;
+            }
+            std::vector<int> witness;
+            manager.AnySat(f, witness);
+            std::string bits;
+            for (int value : witness) bits += value < 0 ? '-' : static_cast<char>('0' + value);
+            std::printf("Output %zu: %zu nodes, %.6g of 2^%d assignments, e.g. %s\n", o + 1,
+                manager.GetNodeCount(f), manager.SatCount(f), manager.GetVariableCount(), bits.c_str());
+        }
+        std::printf("%zu live nodes, %zu reorders, %zu collections, %.3f s\n", manager.GetLiveNodeCount(),
+            manager.GetReorderCount(), manager.GetCollectionCount(), seconds);
+        return 0;
+    }
+
+    // 时序电路：按周期推进时钟，输入值使用文件中保存的值（或 --inputs）
+    if (cycles >= 0 || simSeconds >= 0) {
+        SequentialCircuit sequential;
+        if (!sequential.Compile(netlist)) {
+            std::fprintf(stderr, "edasim: %s\n", sequential.GetError().c_str());
+            return 1;
+        }
+        const CompiledCircuit& logic = sequential.GetCombinational();
+        size_t numInputs = logic.GetInputSlots().size();
+        if (!inputBits.empty()) {
+            if (inputBits.size() != numInputs) {
+                std::fprintf(stderr, "edasim: expected %zu input bits\n", numInputs);
+                return 1;
+            }
+            for (size_t i = 0; i < numInputs; ++i) sequential.SetInput(i, inputBits[i] == '1');
+        }
+        std::printf("%zu elements, %zu state elements, %zu clocks, %zu gates, %u levels\n",
+            netlist.GetElements().size(), sequential.GetStateElementCount(), sequential.GetClockCount(),
+            logic.GetProgram().size(), logic.GetLevelCount());
+
+        auto start = std::chrono::steady_clock::now();
+        if (simSeconds >= 0) {
+            // 按仿真时间推进：只处理时钟边沿，空闲时间段被跳过
+            uint64_t end = static_cast<uint64_t>(simSeconds * 1e9);
+            while (sequential.GetNextEdgeTime() <= end) sequential.StepToNextEdge();
+        }
+        else {
+            sequential.Run(static_cast<size_t>(cycles));
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (size_t o = 0; o < logic.GetOutputSlots().size(); ++o) std::putchar(sequential.GetOutput(o) ? '1' : '0');
+        std::putchar('\n');
+        double steps = static_cast<double>(sequential.GetStepCount());
+        std::printf("%.0f %s, %llu state changes, %.3f s, %.2f M %s/s\n",
+            steps, simSeconds >= 0 ? "edges" : "steps",
+            static_cast<unsigned long long>(sequential.GetTransitionCount()), seconds,
+            seconds > 0 ? steps / seconds / 1e6 : 0.0, simSeconds >= 0 ? "edges" : "steps");
+        return 0;
+    }
+
+    CompiledCircuit circuit;
+    if (!circuit.Compile(netlist)) {
+        std::fprintf(stderr, "edasim: %s\n", circuit.GetError().c_str());
+        return 1;
+    }
+    size_t numInputs = circuit.GetInputSlots().size();
+    size_t numOutputs = circuit.GetOutputSlots().size();
+    std::printf("%zu elements, %zu inputs, %zu outputs, %zu gates, %u levels\n",
+        netlist.GetElements().size(), numInputs, numOutputs,
+        circuit.GetProgram().size(), circuit.GetLevelCount());
+
+    if (!inputBits.empty()) {
+        if (inputBits.size() != numInputs) {
+            std::fprintf(stderr, "edasim: expected %zu input bits\n", numInputs);
+            return 1;
+        }
+        std::vector<uint8_t> values(circuit.GetSlotCount(), 0);
+        for (size_t i = 0; i < numInputs; ++i) {
+            values[circuit.GetInputSlots()[i]] = inputBits[i] == '1' ? 0xFF : 0x00;
+        }
+        circuit.Evaluate(values.data());
+        for (size_t o = 0; o < numOutputs; ++o) std::putchar(values[circuit.GetOutputSlots()[o]] ? '1' : '0');
+        std::putchar('\n');
+    }
+
+    if (toggles > 0) return BenchmarkToggles(circuit, toggles);
+
+    // 按层并行求值的吞吐量：每个线网 64 路随机激励
+    if (threads >= 0 && benchRuns > 0) {
+        std::vector<uint64_t> values(circuit.GetSlotCount(), 0);
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        for (uint32_t slot : circuit.GetInputSlots()) {
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            values[slot] = seed;
+        }
+        ParallelEvaluator evaluator(static_cast<unsigned>(threads));
+        auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < benchRuns; ++run) evaluator.Evaluate(circuit, values.data());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double gateWords = static_cast<double>(circuit.GetProgram().size()) * benchRuns;
+        std::printf("%d runs on %d worker threads, %.3f s, %.1f M gate-words/s, %zu of %u levels parallel\n",
+            benchRuns, threads, seconds, gateWords / seconds / 1e6,
+            evaluator.GetParallelLevelCount(), circuit.GetLevelCount());
+        return 0;
+    }
+
+    if (printTable || benchRuns > 0 || minimize) {
+        if (numInputs > static_cast<size_t>(TruthTableData::MAX_INPUTS)) {
+            std::fprintf(stderr, "edasim: too many inputs for a truth table (%zu)\n", numInputs);
+            return 1;
+        }
+        TruthTableData table;
+        ParallelTruthTable parallel;
+        auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < std::max(benchRuns, 1); ++run) {
+            if (jobs < 0) {
+                BitParallelTruthTable::Generate(circuit, table);
+                continue;
+            }
+            parallel.Start(circuit, static_cast<unsigned>(jobs));
+            parallel.Wait();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (jobs >= 0) std::swap(table, parallel.GetTable());
+
+        if (printTable) {
+            for (uint64_t row = 0; row < table.rows; ++row) {
+                for (int i = 0; i < table.numInputs; ++i) std::putchar(table.GetInput(row, i) ? '1' : '0');
+                std::putchar(' ');
+                for (int o = 0; o < table.numOutputs; ++o) std::putchar(table.GetOutput(row, o) ? '1' : '0');
+                std::putchar('\n');
+            }
+        }
+        if (benchRuns > 0) {
+            double rowsPerSecond = static_cast<double>(table.rows) * benchRuns / seconds;
+            std::printf("%d runs, %.3f s, %.1f Mrows/s (%s kernel)\n", benchRuns, seconds, rowsPerSecond / 1e6,
+                VectorizedCircuit::GetKernelName(VectorizedCircuit::DetectKernel()));
+        }
+        if (minimize) return MinimizeOutputs(netlist, table, synthesizeFile);
+    }
+    return 0;
+}